@@ -1,27 +1,120 @@
 #pragma once
 
-#include <list>
+#include <cstdint>
+#include <stdexcept>
 
-#include <math/uwd_graph.hpp>
+#include <aco/colony_state.hpp>
 
 namespace arti::aco {
-    using graph_t = math::uwd_graph<double>;
 
-    struct ant {
-        ant(graph_t &g);
-        
-        graph_t::node_id currNode();
+    // Handle to one ant of a colony_state, cheap to copy.
+    // Every call reads or writes that ant's slice of the colony arrays
+    class ant {
+
+    public:
+        ant(colony_state &colony, int32_t index)
+          : m_path(colony.path(index)),
+            m_visited(colony.visited(index)),
+            m_pathSize(colony.pathSizes() + index),
+            m_length(colony.lengths() + index),
+            m_epoch(colony.epochs() + index),
+            m_stuck(colony.stuck() + index),
+            m_graphSize(colony.nodesCount()) {
+        }
+
+        graph_t::node_id currNode() const {
+            return m_path[*m_pathSize - 1];
+        }
+
         void reset();
-        void visitNode(graph_t::node_id nodeId);
-        double distanceTraveled();
-
-        uint64_t id;
-        bool stuck;
-        bool precalcDistance;
-        double traveledDistance;
-        std::list<graph_t::node_id> path;
-        std::unordered_map<graph_t::node_id, bool> visited;
-        
-        graph_t &graph;
+
+        // distance is the weight of the edge from the current node
+        void visitNode(graph_t::node_id nodeId, double distance = 0.0) {
+            if (isVisited(nodeId)) {
+                throw std::runtime_error("HOW THIS HAPPENED?");
+            }
+            m_visited[nodeId] = *m_epoch;
+            *m_length += distance;
+            m_path[(*m_pathSize)++] = nodeId;
+        }
+
+        // Steps back from the current node, distance is the weight of the edge
+        // that led to it. The node stays marked as visited until forgetNode
+        void popNode(double distance) {
+            *m_length -= distance;
+            --(*m_pathSize);
+        }
+
+        // Marks a node so the ant doesn't choose it, without going there
+        void excludeNode(graph_t::node_id nodeId) {
+            m_visited[nodeId] = *m_epoch;
+        }
+
+        // The node isn't visited anymore, 0 is never an epoch
+        void forgetNode(graph_t::node_id nodeId) {
+            m_visited[nodeId] = 0;
+        }
+
+        // Adds the edge from the last node back to the first one
+        void closePath(double distance) {
+            *m_length += distance;
+        }
+
+        // A node is visited if its stamp is the current epoch
+        bool isVisited(graph_t::node_id nodeId) const {
+            return m_visited[nodeId] == *m_epoch;
+        }
+
+        double distanceTraveled() const {
+            return *m_stuck ? graph_t::inf : *m_length;
+        }
+
+        // The ant has no path, it either got stuck or was abandoned
+        bool stuck() const {
+            return *m_stuck;
+        }
+
+        void markStuck() {
+            *m_stuck = 1;
+        }
+
+        // Its path couldn't beat the best one anymore, so it wasn't finished
+        bool abandoned() const {
+            return *m_stuck == 2;
+        }
+
+        void markAbandoned() {
+            *m_stuck = 2;
+        }
+
+        // Length of the path so far, even for ants without a path
+        double partialLength() const {
+            return *m_length;
+        }
+
+        const graph_t::node_id* path() const {
+            return m_path;
+        }
+
+        int32_t pathSize() const {
+            return *m_pathSize;
+        }
+
+        const uint32_t* visitStamps() const {
+            return m_visited;
+        }
+
+        uint32_t epoch() const {
+            return *m_epoch;
+        }
+
+    private:
+        graph_t::node_id *m_path;
+        uint32_t *m_visited;
+        int32_t *m_pathSize;
+        double *m_length;
+        uint32_t *m_epoch;
+        uint8_t *m_stuck;
+        int32_t m_graphSize;
     };
 }
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <variant>
+#include <optional>
+#include <string_view>
+
+#include <math/uwd_graph.hpp>
+#include <math/dense_graph.hpp>
+#include <math/csr_graph.hpp>
+#include <utils/rand.hpp>
+#include <utils/thread_pool.hpp>
+
+#include <aco/ant.hpp>
+#include <aco/local_search.hpp>
+
+namespace arti::aco {
+
+    // How the pheromone trails are updated after every iteration
+    enum class update_rule {
+        // Every ant deposits 1 / length
+        ant_system,
+        // Only the iteration best or the global best deposits,
+        // the trails are kept in [tauMin, tauMax] and reinitialized on stagnation
+        max_min,
+        // Ant Colony System, the ants take the best edge with probability q0
+        // and wear the trails they cross, only the global best deposits
+        colony_system,
+        // Every ant deposits and the global best once more, weighted by elitistWeight
+        elitist,
+        // Only the rankedAnts - 1 best ants of the iteration deposit, weighted by
+        // their rank, and the global best with a weight of rankedAnts
+        rank_based,
+        // Population-based ACO, the last populationSize iteration best paths
+        // form the trails: each one adds a share to its edges when it enters
+        // and takes it back when it leaves, there's no evaporation
+        population
+    };
+
+    // How the paths of an iteration are built
+    enum class construction_mode {
+        // Every ant builds its own path
+        ants,
+        // Beam-ACO (Blum), nAnts partial paths grow one node at a time:
+        // each one samples beamExtensions next nodes with the usual rule and
+        // only the nAnts extensions with the lowest length plus a lower bound
+        // of the rest of the cycle are kept. ACS doesn't wear the trails then
+        beam,
+        // Every ant builds its own path and steps back from dead ends to try
+        // another node, at most backtrackLimit times per path. The moves that
+        // would leave the nodes to visit disconnected, or unable to close
+        // the cycle, are never taken. ACS doesn't wear the trails then
+        backtracking
+    };
+
+    // Names used to store the rule, "ant_system", "max_min"...
+    const char* updateRuleName(update_rule rule);
+    std::optional<update_rule> updateRuleFromName(std::string_view name);
+
+    // Names used to store the construction, "ants", "beam" or "backtracking"
+    const char* constructionModeName(construction_mode mode);
+    std::optional<construction_mode> constructionModeFromName(std::string_view name);
+
+    struct colony_params {
+        int nAnts = 10;
+
+        double alpha = 1.5;
+        double beta = 1.35;
+        double rho = 0.02;
+
+        // Threads building paths, 0 means one per hardware thread
+        int nThreads = 0;
+
+        // Runs with the same seed and parameters give the same paths whatever
+        // the number of threads, 0 takes a new seed from the system on every reset
+        uint64_t seed = 0;
+
+        // The ants first choose among the nCandidates closest unvisited
+        // neighbors and only scan every neighbor when all of them were
+        // visited, 0 disables the candidate lists
+        int nCandidates = 0;
+
+        update_rule rule = update_rule::ant_system;
+
+        // MAX-MIN: chance of building the best path again once
+        // the trails converged, the lower bound comes from it
+        double pBest = 0.05;
+
+        // MAX-MIN: every that many iterations the global best deposits
+        // instead of the iteration best, 1 always uses the global best
+        int globalBestPeriod = 10;
+
+        // MAX-MIN: iterations without improving the best path before
+        // the trails are reinitialized, 0 never reinitializes them
+        int stagnationLimit = 250;
+
+        // ACS: chance of taking the edge with the most choice info instead of sampling
+        double q0 = 0.9;
+
+        // ACS: how much of the trail goes back to its initial level every time an ant crosses it
+        double xi = 0.1;
+
+        // Elitist: how many ants the global best path counts for
+        double elitistWeight = 10.0;
+
+        // Rank-based: weight of the global best, the ants of the iteration go from rankedAnts - 1 down to 1
+        int rankedAnts = 6;
+
+        // P-ACO: paths kept in the population
+        int populationSize = 5;
+
+        construction_mode construction = construction_mode::ants;
+
+        // Beam-ACO: next nodes sampled for every partial path of the beam
+        int beamExtensions = 3;
+
+        // Backtracking: steps back allowed to every ant on every iteration
+        int backtrackLimit = 100;
+
+        // Branch and bound: an ant stops building its path once its length plus
+        // the cheapest edge of its node and of every node left to visit reaches
+        // the best length. Abandoned ants don't deposit, and under a local search
+        // their paths might have been improved below the best one
+        bool pruneAnts = false;
+
+        // Improvement of the paths once the ants built them
+        local_search localSearch = local_search::none;
+
+        // Only the best path of every iteration is improved instead of every path
+        bool localSearchBestOnly = false;
+
+        // Closest neighbors of a node tried by the local search moves
+        int localSearchNeighbors = 10;
+
+        // Paths of at least this many nodes are improved on a two-level
+        // list instead of the array, 0 always uses the array
+        int localSearchListNodes = 50000;
+    };
+
+    class colony_solver {
+
+    public:
+        using path_t = std::vector<graph_t::node_id>;
+        using dense_graph_t = math::dense_graph<double>;
+        using csr_graph_t = math::csr_graph<double>;
+
+    public:
+        colony_solver(const graph_t &g, colony_params params = {});
+
+        // Takes a snapshot of the current graph and rebuilds
+        // the pheromone trails and the ants from it.
+        // Dense graphs are stored as a matrix, sparse ones in CSR format
+        void reset();
+        void reset(colony_params params);
+
+        // Changes the parameters without losing the current state,
+        // the colony is rebuilt only if the number of ants changed
+        void setParams(colony_params params);
+
+        // Runs one iteration of the algorithm (every ant builds a path,
+        // the trails vanish and the ants leave their pheromones)
+        void step();
+        void run(int nSteps);
+
+        const path_t& best() const;
+        double bestLength() const;
+        double iterationBestLength() const;
+
+        double pheromone(graph_t::node_id node_A, graph_t::node_id node_B) const;
+        double maxPheromone() const;
+
+        // Bounds of the trails under MAX-MIN, both are 0 until there's a best path
+        double tauMin() const;
+        double tauMax() const;
+        int restarts() const;
+
+        // Ants abandoned by the pruning since the last reset
+        int64_t abandonedAnts() const;
+
+        const colony_params& params() const;
+
+        // The seed of the current run, the one of the parameters unless it was 0
+        uint64_t seed() const;
+        int iterations() const;
+        bool isDense() const;
+
+    private:
+        template<typename graph_type>
+        void constructPaths(const graph_type &graph);
+
+        template<typename graph_type>
+        void constructPath(const graph_type &graph, ant &ant, random::generator &gen, double *choices);
+
+        // ACS, every ant takes one step at a time and the
+        // trails they crossed are worn before the next step
+        template<typename graph_type>
+        void constructPathsLockstep(const graph_type &graph);
+
+        // Scratch of one thread for the backtracking construction
+        struct backtrack_workspace {
+            // Nodes this ant can't go to from its current node, they carry
+            // the visited stamp without being in the path
+            std::vector<graph_t::node_id> excluded;
+
+            // Per node, its neighbors out of the path, if it's in the
+            // path and if it's a neighbor of the first node of the path
+            std::vector<int32_t> freeDegree;
+            std::vector<uint8_t> inPath;
+            std::vector<uint8_t> nearFirst;
+
+            // Searches over the nodes out of the path, a node marked with the
+            // current epoch was reached by searches[node]. The searches that
+            // met share a group, active counts the ones of a group still going
+            std::vector<uint32_t> marks;
+            uint32_t epoch = 0;
+            std::vector<int32_t> searches;
+            std::vector<std::vector<graph_t::node_id>> queues;
+            std::vector<std::size_t> heads;
+            std::vector<int32_t> groups;
+            std::vector<int32_t> active;
+        };
+
+        template<typename graph_type>
+        void constructPathBacktracking(const graph_type &graph, ant &ant, random::generator &gen, backtrack_workspace &workspace);
+
+        // After moving to next, every node left has two neighbors the cycle
+        // could still use, both ends of the rest of the path have a node left
+        // to go to and the nodes left are still connected
+        template<typename graph_type>
+        bool keepsCycle(const graph_type &graph, const ant &ant, graph_t::node_id next, backtrack_workspace &workspace) const;
+
+        // The nodes out of the path, connected so far, stay connected without removed
+        template<typename graph_type>
+        bool staysConnected(const graph_type &graph, graph_t::node_id removed, backtrack_workspace &workspace) const;
+
+        // Beam-ACO, the beam is m_colony and the next one is built in m_beam
+        template<typename graph_type>
+        void constructPathsBeam(const graph_type &graph);
+
+        // The ant can't beat the best path anymore, unvisitedBound is the sum of
+        // the cheapest edges of the nodes it didn't visit
+        bool hopeless(const ant &ant, double unvisitedBound) const;
+
+        // choice is the uniform draw in [0, 1) of this step
+        template<typename graph_type>
+        std::size_t chooseEdge(const graph_type &graph, const ant &ant, double choice) const;
+
+        template<typename graph_type>
+        void localUpdate(const graph_type &graph, graph_t::node_id node_A, graph_t::node_id node_B);
+
+        template<typename graph_type>
+        void initialTrail(const graph_type &graph);
+        void resetTrails(double level);
+
+        template<typename graph_type>
+        void buildCandidates(const graph_type &graph);
+
+        template<typename graph_type>
+        void improvePaths(const graph_type &graph);
+
+        template<typename graph_type>
+        void computeHeuristic(const graph_type &graph);
+        void computeChoiceInfo();
+
+        template<typename graph_type>
+        void computeCheapestEdges(const graph_type &graph);
+
+        void resizePool();
+
+        // m_deltas is only allocated under MAX-MIN
+        void allocateDeltas();
+
+        template<typename graph_type>
+        void updatePheromones(const graph_type &graph);
+
+        template<typename graph_type>
+        void depositPath(const graph_type &graph, const graph_t::node_id *path, int32_t pathSize, double amount);
+
+        template<typename graph_type>
+        void depositAll(const graph_type &graph);
+
+        template<typename graph_type>
+        void depositRanked(const graph_type &graph);
+
+        void updateBounds();
+        void reinitializeTrails();
+
+        // The rules whose evaporation is only a change of m_scale
+        bool lazyEvaporation() const;
+
+        // The ants deposit straight into the trails instead of m_deltas
+        bool directDeposits() const;
+
+        // P-ACO, empties the population and sets every trail to the base level
+        void resetPopulation();
+
+        template<typename graph_type>
+        void updatePopulation(const graph_type &graph, int32_t chosenPath);
+
+        // Below it m_scale is folded back into the trails
+        double minScale() const;
+        void foldScale();
+
+        const graph_t &m_source;
+        std::variant<dense_graph_t, csr_graph_t> m_graph;
+
+        // Indexed by the edge_id of the graph backend, the ants deposit
+        // into m_deltas one after the other, so the sums don't depend on the
+        // threads, and a single pass folds them into the pheromones together
+        // with the evaporation, only MAX-MIN works that way.
+        // Rules without bounds skip that pass, the real trails are
+        // m_pheromones times m_scale and the ants deposit into them directly
+        std::vector<double> m_pheromones;
+        std::vector<double> m_deltas;
+        double m_scale;
+
+        // (1 / weight)^beta, only changes with the graph or beta, and
+        // pheromones^alpha * heuristic, refreshed with every pheromone update.
+        // Both are 0 for edges that don't exist
+        std::vector<double> m_heuristic;
+        std::vector<double> m_choiceInfo;
+
+        // m_candidatesStride slots per node sorted by weight, nodes with
+        // less neighbors than that only use the first m_candidatesCount.
+        // Shared by the construction (first nCandidates) and the local search
+        std::vector<candidate> m_candidates;
+        std::vector<int32_t> m_candidatesCount;
+        int32_t m_candidatesStride;
+
+        // Weight of the cheapest edge of every node and their sum. Every node
+        // is left once by a cycle, so the cheapest edges of the nodes left to
+        // visit bound the rest of a path from below
+        std::vector<double> m_cheapestEdge;
+        double m_cheapestTotal;
+
+        // Number of neighbors of every node
+        std::vector<int32_t> m_degrees;
+
+        colony_params m_params;
+        colony_state m_colony;
+
+        // Beam-ACO: one sampled next node of a partial path of the beam
+        struct beam_extension {
+            int32_t parent;
+            std::size_t edge;
+            double bound;
+        };
+
+        colony_state m_beam;
+        std::vector<beam_extension> m_extensions;
+        std::vector<int32_t> m_extensionOrder;
+
+        // Per ant or partial path of the beam, the sum of the
+        // cheapest edges of the nodes it didn't visit
+        std::vector<double> m_unvisitedBounds;
+        std::vector<double> m_nextUnvisitedBounds;
+
+        // Indices of the ants, partially sorted by length for the rank-based rule
+        std::vector<int32_t> m_ranking;
+
+        // One random stream per ant, reseeded every iteration
+        // from (seed, iteration, ant) so no stream depends on the
+        // thread that runs the ant
+        utils::thread_pool m_pool;
+        std::vector<random::generator> m_generators;
+        std::vector<local_optimizer> m_optimizers;
+
+        // Per worker, the draws of the ant it's running
+        std::vector<std::vector<double>> m_choices;
+        std::vector<backtrack_workspace> m_workspaces;
+        uint64_t m_seed;
+
+        path_t m_bestPath;
+        double m_bestPathLength;
+        double m_iterationBestLength;
+
+        // In the same units as m_pheromones
+        double m_maxPheromone;
+        int m_iterations;
+
+        double m_tauMin;
+        double m_tauMax;
+
+        // ACS: 1 / (n * length of a greedy path)
+        double m_tau0;
+        int m_lastImprovement;
+        int m_restarts;
+        int64_t m_abandoned;
+
+        // P-ACO: ring of paths of m_colony.nodesCount() nodes, from the oldest at m_populationHead
+        std::vector<graph_t::node_id> m_population;
+        int32_t m_populationHead;
+        int32_t m_populationCount;
+    };
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include <math/uwd_graph.hpp>
+
+namespace arti::aco {
+    using graph_t = math::uwd_graph<double>;
+
+    // State of every ant of the colony as structure of arrays:
+    // paths, visited stamps, path sizes, lengths, epochs and stuck flags
+    // (0 the path is complete, 1 stuck, 2 abandoned).
+    // All of them are carved from a single arena that only grows, so changing
+    // the number of ants or nodes is one allocation at most, usually none.
+    // Every ant's path and visited rows start on their own cache line
+    class colony_state {
+
+    public:
+        colony_state();
+
+        colony_state(const colony_state&) = delete;
+        colony_state& operator=(const colony_state&) = delete;
+
+        // Forgets every path
+        void resize(int32_t nAnts, int32_t nNodes);
+
+        // Exchanges the ants of both colonies, no copies
+        void swap(colony_state &other);
+
+        // Overwrites the ant toAnt with the ant fromAnt of another colony of
+        // the same size: its path so far, visited nodes, length and flags
+        void copyAnt(const colony_state &from, int32_t fromAnt, int32_t toAnt);
+
+        int32_t antsCount() const;
+        int32_t nodesCount() const;
+
+        graph_t::node_id* path(int32_t ant);
+        const graph_t::node_id* path(int32_t ant) const;
+        uint32_t* visited(int32_t ant);
+        const uint32_t* visited(int32_t ant) const;
+
+        int32_t* pathSizes();
+        double* lengths();
+        uint32_t* epochs();
+        uint8_t* stuck();
+
+        const int32_t* pathSizes() const;
+        const double* lengths() const;
+        const uint32_t* epochs() const;
+        const uint8_t* stuck() const;
+
+    private:
+        static constexpr const std::size_t cacheLine = 64;
+
+        std::unique_ptr<std::byte[]> m_arena;
+        std::size_t m_capacity;
+
+        int32_t m_nAnts;
+        int32_t m_nNodes;
+
+        // Elements between the rows of two consecutive ants
+        std::size_t m_pathStride;
+        std::size_t m_visitedStride;
+
+        graph_t::node_id *m_paths;
+        uint32_t *m_visited;
+        int32_t *m_pathSizes;
+        double *m_lengths;
+        uint32_t *m_epochs;
+        uint8_t *m_stuck;
+    };
+
+}
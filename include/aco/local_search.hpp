@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include <aco/colony_state.hpp>
+#include <aco/tour.hpp>
+
+namespace arti::aco {
+
+    // Improvement applied to the paths of the ants after building them
+    enum class local_search {
+        none,
+        two_opt,
+        // Moves segments of 1 to 3 nodes somewhere else, in either direction
+        or_opt,
+        // 2-opt and Or-opt moves together with the pure 3-opt move (or3opt),
+        // which takes a segment of any length and puts it somewhere else
+        // without reversing it, the new edges come from the neighbor lists
+        three_opt
+    };
+
+    // Names used to store the local search, "none", "two_opt"...
+    const char* localSearchName(local_search kind);
+    std::optional<local_search> localSearchFromName(std::string_view name);
+
+    // Neighbor of a node in the nearest neighbors lists
+    struct candidate {
+        graph_t::node_id node;
+        std::size_t edge;
+    };
+
+    // Nearest neighbors lists of every node, stride slots per node sorted
+    // by weight, of which only the first count[node] are used
+    struct neighbor_lists {
+        const candidate *lists;
+        const int32_t *count;
+        int32_t stride;
+
+        // Only the first nNeighbors of every list are tried
+        int32_t nNeighbors;
+    };
+
+    // Workspace of the local search for one thread, keeps
+    // its buffers between calls so it only allocates when the
+    // number of nodes grows
+    class local_optimizer {
+
+    public:
+        local_optimizer();
+
+        // Improves the cycle stored in path in place until no move of the
+        // kind improves it, only the nodes around an improvement are looked
+        // at again (don't look bits). Returns the change of its length (<= 0).
+        // The moves work on the array itself or, for huge paths, on a two-level list
+        template<typename graph_type>
+        double improve(const graph_type &graph, local_search kind, graph_t::node_id *path, int32_t pathSize, const neighbor_lists &neighbors, bool twoLevelList = false);
+
+    private:
+        template<typename graph_type, typename tour_type>
+        double search(const graph_type &graph, tour_type &tour, local_search kind, const neighbor_lists &neighbors);
+
+        // Both search from one node with its neighbor lists and apply the
+        // first improvement found, returning its change of length (0 if none)
+        template<typename graph_type, typename tour_type>
+        double tryTwoOpt(const graph_type &graph, tour_type &tour, graph_t::node_id nodeA, const neighbor_lists &neighbors);
+
+        template<typename graph_type, typename tour_type>
+        double tryOrOpt(const graph_type &graph, tour_type &tour, graph_t::node_id nodeS, const neighbor_lists &neighbors);
+
+        template<typename graph_type, typename tour_type>
+        double trySegmentInsertion(const graph_type &graph, tour_type &tour, graph_t::node_id node1, const neighbor_lists &neighbors);
+
+        // Replaces the edges (a, b) and (c, d) by (a, c) and (b, d), b and d must be
+        // both the successors or both the predecessors of a and c
+        template<typename tour_type>
+        void exchange(tour_type &tour, graph_t::node_id nodeA, graph_t::node_id nodeB, graph_t::node_id nodeC, graph_t::node_id nodeD);
+
+        void prepare(const graph_t::node_id *path, int32_t pathSize);
+        void push(graph_t::node_id node);
+        graph_t::node_id pop();
+
+        // Longest segment moved by Or-opt
+        static constexpr const int32_t maxSegment = 3;
+
+        array_tour m_array;
+        two_level_list m_list;
+
+        // Nodes waiting to be looked at, a node is in the queue iff its don't look bit is clear
+        std::vector<uint8_t> m_dontLook;
+        std::vector<graph_t::node_id> m_queue;
+        std::size_t m_queueHead;
+        std::size_t m_queueSize;
+    };
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace arti::aco {
+
+    // Roulette wheel over a row of weights where visited[i] == epoch masks weights[i] out.
+    // Returns the index i such that the masked prefix sum up to i first passes
+    // choice * (sum of the masked weights), choice must be in [0, 1).
+    // Returns -1 if every weight is masked or zero.
+    // Uses AVX2 when the cpu supports it, checked once at runtime
+    int32_t rouletteSelect(const double *weights, const uint32_t *visited, uint32_t epoch, int32_t count, double choice);
+
+    bool simdSelectionEnabled();
+
+    // Index of the largest weight that isn't masked, -1 if all of them are masked or zero
+    int32_t argmaxSelect(const double *weights, const uint32_t *visited, uint32_t epoch, int32_t count);
+
+}
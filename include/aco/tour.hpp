@@ -0,0 +1,142 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <aco/colony_state.hpp>
+
+namespace arti::aco {
+
+    // Both tours are cycles over the nodes [0, size) with the same operations:
+    //  next / prev:       neighbors of a node walking forward / backward
+    //  between(a, b, c):  b is on the path from a to c walking forward (both included)
+    //  reverse(a, b):     reverses the path from a to b walking forward, it may
+    //                     reverse the rest of the cycle instead, which gives the same cycle
+
+    // The path array itself plus the position of every node in it.
+    // next, prev and between are O(1), reverse is O(n)
+    class array_tour {
+
+    public:
+        array_tour();
+
+        // Works directly on path until the next build
+        void build(graph_t::node_id *path, int32_t pathSize);
+
+        graph_t::node_id next(graph_t::node_id node) const {
+            auto position = m_position[node] + 1;
+            return m_path[position == m_pathSize ? 0 : position];
+        }
+
+        graph_t::node_id prev(graph_t::node_id node) const {
+            auto position = m_position[node];
+            return m_path[position == 0 ? m_pathSize - 1 : position - 1];
+        }
+
+        bool between(graph_t::node_id node_A, graph_t::node_id node_B, graph_t::node_id node_C) const;
+        void reverse(graph_t::node_id node_A, graph_t::node_id node_B);
+
+    private:
+        graph_t::node_id *m_path;
+        int32_t m_pathSize;
+        std::vector<int32_t> m_position;
+    };
+
+    // Two-level doubly-linked list (Fredman et al.), the cycle is cut in about
+    // sqrt(n) segments with a reversed bit each, kept in a cyclic list.
+    // next, prev and between are O(1), reverse is O(sqrt(n)): it only
+    // reorders the nodes of at most two segments and reverses a run of
+    // whole segments by flipping their bits
+    class two_level_list {
+
+    public:
+        two_level_list();
+
+        void build(const graph_t::node_id *path, int32_t pathSize);
+
+        // Writes the cycle back as an array
+        void toPath(graph_t::node_id *path) const;
+
+        graph_t::node_id next(graph_t::node_id node) const {
+            auto segment = m_parent[node];
+            if (node == forwardLast(segment))
+                return forwardFirst(m_segmentNext[segment]);
+            return m_reversed[segment] ? m_pred[node] : m_succ[node];
+        }
+
+        graph_t::node_id prev(graph_t::node_id node) const {
+            auto segment = m_parent[node];
+            if (node == forwardFirst(segment))
+                return forwardLast(m_segmentPrev[segment]);
+            return m_reversed[segment] ? m_succ[node] : m_pred[node];
+        }
+
+        bool between(graph_t::node_id node_A, graph_t::node_id node_B, graph_t::node_id node_C) const;
+        void reverse(graph_t::node_id node_A, graph_t::node_id node_B);
+
+    private:
+        graph_t::node_id forwardFirst(int32_t segment) const {
+            return m_reversed[segment] ? m_last[segment] : m_first[segment];
+        }
+
+        graph_t::node_id forwardLast(int32_t segment) const {
+            return m_reversed[segment] ? m_first[segment] : m_last[segment];
+        }
+
+        // Order of the node along the cycle, starting from the segment of rank 0
+        int64_t key(graph_t::node_id node) const;
+
+        // Appends the nodes of one segment walking forward, from node_A to node_B
+        void collect(graph_t::node_id node_A, graph_t::node_id node_B, std::vector<graph_t::node_id> &nodes) const;
+
+        // Gives the segment these nodes in this (forward) order
+        void assign(int32_t segment, const std::vector<graph_t::node_id> &nodes);
+
+        // Reverses the path from node_A to node_B inside one segment
+        void reverseInside(int32_t segment, graph_t::node_id node_A, graph_t::node_id node_B);
+
+        // Reverses the run of whole segments from first to last
+        void reverseSegments(int32_t first, int32_t last);
+
+        // Moves the smaller side of the segment of the node to the neighbor
+        // segment so the node ends up first / last of its segment.
+        // splitAfter doesn't prepend nodes to keep, its first node stays first
+        void splitBefore(graph_t::node_id node);
+        void splitAfter(graph_t::node_id node, int32_t keep);
+
+        // Position of the node inside its segment walking forward
+        int32_t offset(graph_t::node_id node) const {
+            auto segment = m_parent[node];
+            return m_reversed[segment] ? m_segmentSize[segment] - 1 - m_id[node] : m_id[node];
+        }
+
+        int32_t m_size;
+        int32_t m_groupSize;
+        int32_t m_segmentsCount;
+
+        // A segment grew too much, the segments are rebuilt after the reversal
+        bool m_unbalanced;
+
+        // Per node, the links and ids follow the order inside the segment,
+        // the reversed bit of the segment tells if that's forward or backward
+        std::vector<int32_t> m_parent;
+        std::vector<int32_t> m_id;
+        std::vector<graph_t::node_id> m_succ;
+        std::vector<graph_t::node_id> m_pred;
+
+        // Per segment
+        std::vector<uint8_t> m_reversed;
+        std::vector<graph_t::node_id> m_first;
+        std::vector<graph_t::node_id> m_last;
+        std::vector<int32_t> m_segmentSize;
+        std::vector<int32_t> m_rank;
+        std::vector<int32_t> m_segmentNext;
+        std::vector<int32_t> m_segmentPrev;
+
+        // Scratch buffers of the reversals
+        std::vector<graph_t::node_id> m_nodes;
+        std::vector<graph_t::node_id> m_moved;
+        std::vector<int32_t> m_segments;
+    };
+
+}
@@ -19,7 +19,7 @@
 #include <utils/rand.hpp>
 #include <math/uwd_graph.hpp>
 
-#include <aco/ant.hpp>
+#include <aco/colony_solver.hpp>
 
 using arti::render::key_t;
 using arti::render::button_t;
@@ -51,27 +51,12 @@ namespace arti {
         float accTime;
 
         graph_t g;
-        graph_t ph;
-
-        std::list<aco::ant> ants;
-
-        std::list<graph_t::node_id> bestPathSoFar;
-        double bestPathSoFarLength;
-
-        double actBestPath;
 
         std::map<graph_t::node_id, math::vec2df> nodesPos;
         double node_size = 8.0;
 
-        int nAlgoStep;
-
-        int nAnts = 10;
-
-        double alpha = 1.5;
-        double beta = 1.35;
-        double rho = 0.02;
-
-        double maxPheromone = 1.0;
+        aco::colony_params params;
+        aco::colony_solver solver{g, params};
 
         bool addNode;
         bool algoStep;
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace arti::headless {
+
+    // True if the arguments ask for the batch mode (--headless)
+    bool requested(int argc, char** argv);
+
+    // Loads an instance, runs the solver on it without opening a window and
+    // writes the results to stdout or a json file. Returns the exit code
+    int run(int argc, char** argv);
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <json.hpp>
+
+#include <math/vec2d.hpp>
+#include <aco/colony_solver.hpp>
+
+namespace arti::io {
+
+    using aco::graph_t;
+
+    // The parameters stored under "algorithmParameters", readParams
+    // only changes the ones the json has
+    void readParams(const nlohmann::json &algoParams, aco::colony_params &params);
+    nlohmann::json writeParams(const aco::colony_params &params, uint64_t seed);
+
+    // Files written by "Save data": a weights matrix under "graph", where the
+    // missing edges are inf, and optionally the nodes coordinates and parameters.
+    // coords is only filled for the nodes the file has coordinates for
+    bool loadJson(const std::string &filename, graph_t &g, aco::colony_params &params, std::map<graph_t::node_id, math::vec2df> *coords = nullptr);
+
+    // The number of nodes followed by the whole weights matrix, row by row
+    bool loadWeightsMatrix(const std::string &filename, graph_t &g);
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#include <math/uwd_graph.hpp>
+
+namespace arti::math {
+
+    // Read only compressed sparse row snapshot of an undirected weighted graph.
+    // The neighbors of a node are the contiguous range [offsets[node], offsets[node + 1])
+    // of the neighbors and weights arrays, sorted by node id.
+    // The position in those arrays is the edge_id, so per edge data (i.e pheromones)
+    // can be kept in parallel arrays of edgeSlots() elements
+    template<typename weight_t = double>
+    class csr_graph {
+
+    public:
+        using node_id = int32_t;
+        using edge_id = std::size_t;
+        static constexpr const weight_t inf = std::numeric_limits<weight_t>::max();
+        static constexpr const edge_id no_edge = std::numeric_limits<edge_id>::max();
+
+    public:
+        csr_graph() {
+            m_offsets.assign(1, 0);
+        }
+
+        explicit csr_graph(const uwd_graph<weight_t> &other) {
+            m_offsets.reserve(other.size() + 1);
+            m_neighbors.reserve(2 * static_cast<std::size_t>(other.edgesCount()));
+            m_weights.reserve(2 * static_cast<std::size_t>(other.edgesCount()));
+
+            m_offsets.push_back(0);
+            for (auto& [it, neighbors] : other) {
+                for (auto& [neigh, weight] : neighbors) {
+                    m_neighbors.push_back(neigh);
+                    m_weights.push_back(weight);
+                }
+                m_offsets.push_back(m_neighbors.size());
+            }
+        }
+
+        bool areConnected(node_id node_A, node_id node_B) const {
+            return findEdge(node_A, node_B) != no_edge;
+        }
+
+        weight_t getWeigth(node_id node_A, node_id node_B) const {
+            auto edge = findEdge(node_A, node_B);
+            return edge == no_edge ? inf : m_weights[edge];
+        }
+
+        // Binary search on the (sorted) neighbors of node_A
+        edge_id findEdge(node_id node_A, node_id node_B) const {
+            auto first = m_neighbors.begin() + m_offsets[node_A];
+            auto last = m_neighbors.begin() + m_offsets[node_A + 1];
+            auto it = std::lower_bound(first, last, node_B);
+            if (it == last || *it != node_B)
+                return no_edge;
+            return static_cast<edge_id>(it - m_neighbors.begin());
+        }
+
+        edge_id edgeId(node_id node_A, node_id node_B) const {
+            return findEdge(node_A, node_B);
+        }
+
+        // Size of any array indexed by edge_id
+        std::size_t edgeSlots() const {
+            return m_neighbors.size();
+        }
+
+        // Calls fn(neighbor, weight, edge) for every neighbor of the node
+        template<typename function_t>
+        void forEachNeighbor(node_id node, function_t &&fn) const {
+            for (edge_id edge = m_offsets[node]; edge < m_offsets[node + 1]; ++edge) {
+                fn(m_neighbors[edge], m_weights[edge], edge);
+            }
+        }
+
+        edge_id edgesBegin(node_id node) const {
+            return m_offsets[node];
+        }
+
+        edge_id edgesEnd(node_id node) const {
+            return m_offsets[node + 1];
+        }
+
+        node_id target(edge_id edge) const {
+            return m_neighbors[edge];
+        }
+
+        weight_t weight(edge_id edge) const {
+            return m_weights[edge];
+        }
+
+        int32_t size() const {
+            return static_cast<int32_t>(m_offsets.size()) - 1;
+        }
+
+        int32_t edgesCount() const {
+            return static_cast<int32_t>(m_neighbors.size() / 2);
+        }
+
+        void reset() {
+            m_offsets.assign(1, 0);
+            m_neighbors.clear();
+            m_weights.clear();
+        }
+
+    private:
+        std::vector<edge_id> m_offsets;
+        std::vector<node_id> m_neighbors;
+        std::vector<weight_t> m_weights;
+    };
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+#include <math/uwd_graph.hpp>
+
+namespace arti::math {
+
+    // Undirected weighted graph stored as a row-major n * n matrix.
+    // Meant for complete (or almost complete) graphs, reading a whole row
+    // is a contiguous walk instead of a tree traversal.
+    // Edges are identified by their slot in the matrix, so any other
+    // n * n array (i.e pheromones) can be indexed with the same edge_id
+    template<typename weight_t = double>
+    class dense_graph {
+
+    public:
+        using node_id = int32_t;
+        using edge_id = std::size_t;
+        static constexpr const weight_t inf = std::numeric_limits<weight_t>::max();
+        static constexpr const edge_id no_edge = std::numeric_limits<edge_id>::max();
+
+    public:
+        dense_graph() {
+            m_size = 0;
+            m_edgesCount = 0;
+        }
+
+        explicit dense_graph(int32_t nNodes) : dense_graph() {
+            resize(nNodes);
+        }
+
+        explicit dense_graph(const uwd_graph<weight_t> &other) : dense_graph(other.size()) {
+            for (auto& [it, neighbors] : other) {
+                for (auto& [neigh, weight] : neighbors) {
+                    if (it < neigh) {
+                        connect(it, neigh, weight);
+                    }
+                }
+            }
+        }
+
+        // Every node ends up disconnected
+        void resize(int32_t nNodes) {
+            m_size = nNodes;
+            m_edgesCount = 0;
+            m_weights.assign(static_cast<std::size_t>(nNodes) * nNodes, inf);
+        }
+
+        void connect(node_id node_A, node_id node_B, weight_t weight) {
+            if (m_weights[edgeId(node_A, node_B)] == inf)
+                m_edgesCount++;
+            m_weights[edgeId(node_A, node_B)] = weight;
+            m_weights[edgeId(node_B, node_A)] = weight;
+        }
+
+        void disconnect(node_id node_A, node_id node_B) {
+            if (m_weights[edgeId(node_A, node_B)] != inf)
+                m_edgesCount--;
+            m_weights[edgeId(node_A, node_B)] = inf;
+            m_weights[edgeId(node_B, node_A)] = inf;
+        }
+
+        bool areConnected(node_id node_A, node_id node_B) const {
+            return m_weights[edgeId(node_A, node_B)] != inf;
+        }
+
+        weight_t getWeigth(node_id node_A, node_id node_B) const {
+            return m_weights[edgeId(node_A, node_B)];
+        }
+
+        edge_id edgeId(node_id node_A, node_id node_B) const {
+            return static_cast<edge_id>(node_A) * m_size + node_B;
+        }
+
+        edge_id findEdge(node_id node_A, node_id node_B) const {
+            return areConnected(node_A, node_B) ? edgeId(node_A, node_B) : no_edge;
+        }
+
+        // Size of any array indexed by edge_id
+        std::size_t edgeSlots() const {
+            return m_weights.size();
+        }
+
+        // Calls fn(neighbor, weight, edge) for every neighbor of the node
+        template<typename function_t>
+        void forEachNeighbor(node_id node, function_t &&fn) const {
+            const weight_t *weights = row(node);
+            edge_id first = edgeId(node, 0);
+            for (node_id it = 0; it < m_size; ++it) {
+                if (weights[it] != inf) {
+                    fn(it, weights[it], first + it);
+                }
+            }
+        }
+
+        node_id target(edge_id edge) const {
+            return static_cast<node_id>(edge % m_size);
+        }
+
+        weight_t weight(edge_id edge) const {
+            return m_weights[edge];
+        }
+
+        const weight_t* row(node_id node) const {
+            return m_weights.data() + edgeId(node, 0);
+        }
+
+        int32_t size() const {
+            return m_size;
+        }
+
+        int32_t edgesCount() const {
+            return m_edgesCount;
+        }
+
+        void reset() {
+            resize(0);
+        }
+
+    private:
+        int32_t m_size;
+        int32_t m_edgesCount;
+        std::vector<weight_t> m_weights;
+    };
+
+}
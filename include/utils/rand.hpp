@@ -1,31 +1,112 @@
 #pragma once
 
 #include <random>
+#include <cstdint>
+#include <cstddef>
 
 namespace arti::random {
 
-    static double f_zero_to_one() {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<> dist(0, 1.0);
+    // Independent random stream, unlike the functions below it isn't
+    // shared, so every thread can own one without locking.
+    // xoshiro256++ (Blackman & Vigna): 32 bytes of state and a few
+    // shifts and adds per number, reseeding only costs four splitmix64 steps
+    class generator {
 
-        return dist(gen);
+    public:
+        explicit generator(uint64_t seed = 0, uint64_t stream = 0) {
+            reseed(seed, stream);
+        }
+
+        // Different streams of the same seed give unrelated sequences
+        void reseed(uint64_t seed, uint64_t stream = 0) {
+            uint64_t state = splitmix64(seed) ^ stream;
+            for (auto &word : m_state)
+                word = splitmix64(state);
+        }
+
+        double f_zero_to_one() {
+            return toUnit(next());
+        }
+
+        double f_neg_to_pos_one() {
+            return 2.0 * toUnit(next()) - 1.0;
+        }
+
+        int32_t i_zero_intMax() {
+            return static_cast<int32_t>(next() >> 33);
+        }
+
+        uint64_t u_zero_uint64Max() {
+            return next();
+        }
+
+        // Fills values with count uniform doubles in [0, 1), the same ones
+        // count calls to f_zero_to_one would give. Meant for the kernels that
+        // want their random numbers in a plain array up front
+        void fill(double *values, std::size_t count) {
+            for (std::size_t i = 0; i < count; ++i)
+                values[i] = toUnit(next());
+        }
+
+    private:
+        static uint64_t rotl(uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        // Advances state and returns a well mixed value of it
+        static uint64_t splitmix64(uint64_t &state) {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        // The top 53 bits as the mantissa of a double in [0, 1)
+        static double toUnit(uint64_t x) {
+            return static_cast<double>(x >> 11) * 0x1.0p-53;
+        }
+
+        uint64_t next() {
+            uint64_t result = rotl(m_state[0] + m_state[3], 23) + m_state[0];
+            uint64_t t = m_state[1] << 17;
+
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= t;
+            m_state[3] = rotl(m_state[3], 45);
+
+            return result;
+        }
+
+        uint64_t m_state[4];
+    };
+
+    namespace detail {
+        inline generator globalGenerator(std::random_device{}(), std::random_device{}());
     }
 
-    static double f_neg_to_pos_one() {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<> dist(-1.0, 1.0);
+    // The stream shared by the whole program, seeded from the system
+    // unless seed() is called. Not thread safe
+    inline generator& global() {
+        return detail::globalGenerator;
+    }
+
+    inline void seed(uint64_t seed) {
+        global().reseed(seed);
+    }
 
-        return dist(gen);
+    inline double f_zero_to_one() {
+        return global().f_zero_to_one();
     }
 
-    static int32_t i_zero_intMax() {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<> dist(0, INT32_MAX);
+    inline double f_neg_to_pos_one() {
+        return global().f_neg_to_pos_one();
+    }
 
-        return dist(gen);
+    inline int32_t i_zero_intMax() {
+        return global().i_zero_intMax();
     }
 
 }
\ No newline at end of file
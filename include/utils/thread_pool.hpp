@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace arti::utils {
+
+    // Fixed set of workers that run parallel loops, the calling thread
+    // takes part as worker 0 so a pool of size 1 doesn't spawn anything
+    class thread_pool {
+
+    public:
+        explicit thread_pool(uint32_t nThreads = 0);
+        ~thread_pool();
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        // 0 means one worker per hardware thread
+        void resize(uint32_t nThreads);
+        uint32_t size() const;
+
+        // Calls fn(index, worker) for every index in [0, count), indices are
+        // handed out one at a time so uneven work balances itself.
+        // Blocks until every index is done, rethrows the first exception
+        template<typename function_t>
+        void parallelFor(std::size_t count, function_t &&fn) {
+            if (m_threads.empty() || count <= 1) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    fn(i, 0);
+                }
+                return;
+            }
+
+            std::atomic<std::size_t> next{0};
+            run([&](uint32_t worker) {
+                for (auto i = next++; i < count; i = next++) {
+                    fn(i, worker);
+                }
+            });
+        }
+
+        // Same as parallelFor but calls fn(first, last, worker) for
+        // consecutive ranges of chunkSize indices, for streaming over arrays
+        template<typename function_t>
+        void parallelForRange(std::size_t count, std::size_t chunkSize, function_t &&fn) {
+            std::size_t nChunks = (count + chunkSize - 1) / chunkSize;
+            parallelFor(nChunks, [&](std::size_t chunk, uint32_t worker) {
+                std::size_t first = chunk * chunkSize;
+                fn(first, std::min(first + chunkSize, count), worker);
+            });
+        }
+
+    private:
+        void run(const std::function<void(uint32_t)> &job);
+        void workerLoop(uint32_t worker);
+        void execute(uint32_t worker);
+        void stop();
+
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wakeUp;
+        std::condition_variable m_finished;
+
+        const std::function<void(uint32_t)> *m_job;
+        std::exception_ptr m_exception;
+        uint64_t m_generation;
+        uint32_t m_pending;
+        bool m_stop;
+    };
+
+}
@@ -1,10 +1,16 @@
 #include <render/init.hpp>
 
 #include <ant_visualization.hpp>
+#include <headless.hpp>
 
 using namespace arti;
 
 int main(int argc, char** argv) {
+    // Batch runs never touch SDL, so they work without a display
+    if (headless::requested(argc, argv)) {
+        return headless::run(argc, argv);
+    }
+
     render::initSDL(render::init_flags::Everything);
 
     AntVisualization app;
@@ -0,0 +1,1282 @@
+#include <aco/colony_solver.hpp>
+
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+
+#include <logger.hpp>
+#include <utils/rand.hpp>
+#include <math/constants.hpp>
+
+#include <aco/selection.hpp>
+
+namespace arti::aco {
+
+    // Stream of an ant in one iteration
+    static uint64_t antStream(int iteration, std::size_t antIdx) {
+        return (static_cast<uint64_t>(iteration) << 32) | static_cast<uint64_t>(antIdx);
+    }
+
+    static const char* const ruleNames[] = {
+        "ant_system",
+        "max_min",
+        "colony_system",
+        "elitist",
+        "rank_based",
+        "population"
+    };
+
+    const char* updateRuleName(update_rule rule) {
+        return ruleNames[static_cast<int>(rule)];
+    }
+
+    std::optional<update_rule> updateRuleFromName(std::string_view name) {
+        for (int it = 0; it < static_cast<int>(std::size(ruleNames)); ++it) {
+            if (name == ruleNames[it])
+                return static_cast<update_rule>(it);
+        }
+        return std::nullopt;
+    }
+
+    static const char* const constructionNames[] = {
+        "ants",
+        "beam",
+        "backtracking"
+    };
+
+    const char* constructionModeName(construction_mode mode) {
+        return constructionNames[static_cast<int>(mode)];
+    }
+
+    std::optional<construction_mode> constructionModeFromName(std::string_view name) {
+        for (int it = 0; it < static_cast<int>(std::size(constructionNames)); ++it) {
+            if (name == constructionNames[it])
+                return static_cast<construction_mode>(it);
+        }
+        return std::nullopt;
+    }
+
+    colony_solver::colony_solver(const graph_t &g, colony_params params)
+      : m_source(g),
+        m_params(params),
+        m_pool(1) {
+        reset();
+    }
+
+    void colony_solver::reset() {
+        m_iterations = 0;
+        m_maxPheromone = 1.0;
+        m_scale = 1.0;
+        m_bestPath.clear();
+        m_bestPathLength = std::numeric_limits<double>::max();
+        m_iterationBestLength = std::numeric_limits<double>::max();
+        m_tauMin = 0.0;
+        m_tauMax = 0.0;
+        m_lastImprovement = 0;
+        m_restarts = 0;
+        m_abandoned = 0;
+        m_populationHead = 0;
+        m_populationCount = 0;
+
+        // The matrix pays off when at least half of the possible edges exist
+        int64_t nNodes = m_source.size();
+        if (4 * static_cast<int64_t>(m_source.edgesCount()) >= nNodes * (nNodes - 1)) {
+            m_graph = dense_graph_t(m_source);
+        }
+        else {
+            m_graph = csr_graph_t(m_source);
+        }
+
+        std::visit([&](auto &graph) {
+            // Every edge of the graph starts with the same amount of pheromones
+            m_pheromones.assign(graph.edgeSlots(), 0.0);
+            for (graph_t::node_id it = 0; it < graph.size(); ++it) {
+                graph.forEachNeighbor(it, [&](graph_t::node_id, double, auto edge) {
+                    m_pheromones[edge] = 1.0;
+                });
+            }
+        }, m_graph);
+        allocateDeltas();
+
+        m_colony.resize(std::max(m_params.nAnts, 0), m_source.size());
+        m_ranking.resize(m_colony.antsCount());
+
+        m_seed = m_params.seed != 0 ? m_params.seed : random::global().u_zero_uint64Max();
+        m_generators.assign(m_colony.antsCount(), random::generator());
+        resizePool();
+
+        std::visit([&](auto &graph) {
+            buildCandidates(graph);
+            computeHeuristic(graph);
+            computeCheapestEdges(graph);
+            initialTrail(graph);
+        }, m_graph);
+        computeChoiceInfo();
+
+        // ACS starts every trail from tau0
+        if (m_params.rule == update_rule::colony_system) {
+            resetTrails(m_tau0);
+        }
+        else if (m_params.rule == update_rule::population) {
+            resetPopulation();
+        }
+    }
+
+    template<typename graph_type>
+    void colony_solver::computeHeuristic(const graph_type &graph) {
+        m_heuristic.assign(graph.edgeSlots(), 0.0);
+        m_choiceInfo.assign(graph.edgeSlots(), 0.0);
+
+        m_pool.parallelFor(graph.size(), [&](std::size_t node, uint32_t) {
+            graph.forEachNeighbor(node, [&](graph_t::node_id, double neighWeight, auto edge) {
+                assert(std::abs(neighWeight) > math::constants::EPS);
+                m_heuristic[edge] = std::pow(1.0 / neighWeight, m_params.beta);
+            });
+        });
+    }
+
+    template<typename graph_type>
+    void colony_solver::computeCheapestEdges(const graph_type &graph) {
+        m_cheapestEdge.assign(graph.size(), 0.0);
+        m_degrees.assign(graph.size(), 0);
+
+        m_pool.parallelFor(graph.size(), [&](std::size_t node, uint32_t) {
+            double cheapest = graph_t::inf;
+            graph.forEachNeighbor(node, [&](graph_t::node_id, double neighWeight, auto) {
+                cheapest = std::min(cheapest, neighWeight);
+                ++m_degrees[node];
+            });
+            m_cheapestEdge[node] = cheapest == graph_t::inf ? 0.0 : cheapest;
+        });
+
+        m_cheapestTotal = std::accumulate(m_cheapestEdge.begin(), m_cheapestEdge.end(), 0.0);
+    }
+
+    void colony_solver::computeChoiceInfo() {
+        m_pool.parallelForRange(m_choiceInfo.size(), 1 << 14, [&](std::size_t first, std::size_t last, uint32_t) {
+            for (std::size_t edge = first; edge < last; ++edge) {
+                m_choiceInfo[edge] = std::pow(m_pheromones[edge], m_params.alpha) * m_heuristic[edge];
+            }
+        });
+    }
+
+    template<typename graph_type>
+    void colony_solver::buildCandidates(const graph_type &graph) {
+        auto nCandidates = static_cast<std::size_t>(std::max(m_params.nCandidates, 0));
+        if (m_params.localSearch != local_search::none) {
+            nCandidates = std::max(nCandidates, static_cast<std::size_t>(std::max(m_params.localSearchNeighbors, 0)));
+        }
+
+        m_candidatesStride = static_cast<int32_t>(nCandidates);
+        m_candidates.assign(nCandidates * graph.size(), {});
+        m_candidatesCount.assign(graph.size(), 0);
+
+        if (nCandidates == 0)
+            return;
+
+        std::vector<std::vector<std::pair<double, candidate>>> neighbors(m_pool.size());
+
+        m_pool.parallelFor(graph.size(), [&](std::size_t node, uint32_t worker) {
+            auto& nodeNeighbors = neighbors[worker];
+            nodeNeighbors.clear();
+            graph.forEachNeighbor(node, [&](graph_t::node_id neighId, double neighWeight, auto edge) {
+                nodeNeighbors.push_back({ neighWeight, { neighId, edge } });
+            });
+
+            // Keep only the closest ones
+            auto count = std::min(nCandidates, nodeNeighbors.size());
+            std::partial_sort(nodeNeighbors.begin(), nodeNeighbors.begin() + count, nodeNeighbors.end(),
+                [](auto &lhs, auto &rhs) { return lhs.first < rhs.first; });
+
+            for (std::size_t i = 0; i < count; ++i) {
+                m_candidates[node * nCandidates + i] = nodeNeighbors[i].second;
+            }
+            m_candidatesCount[node] = static_cast<int32_t>(count);
+        });
+    }
+
+    void colony_solver::resizePool() {
+        m_pool.resize(static_cast<uint32_t>(std::max(m_params.nThreads, 0)));
+
+        m_optimizers.resize(m_pool.size());
+        m_choices.resize(m_pool.size());
+        m_workspaces.resize(m_pool.size());
+    }
+
+    void colony_solver::allocateDeltas() {
+        // The other rules deposit straight into the trails or, under ACS,
+        // only touch the global best, on a dense graph the array alone
+        // would be n^2 doubles for nothing
+        if (m_params.rule == update_rule::max_min)
+            m_deltas.assign(m_pheromones.size(), 0.0);
+        else
+            std::vector<double>().swap(m_deltas);
+    }
+
+    void colony_solver::reset(colony_params params) {
+        m_params = params;
+        reset();
+    }
+
+    void colony_solver::setParams(colony_params params) {
+        bool rebuild = (params.nAnts != m_params.nAnts);
+        bool threads = (params.nThreads != m_params.nThreads);
+        bool candidates = (params.nCandidates != m_params.nCandidates) ||
+            (params.localSearch != m_params.localSearch) ||
+            (params.localSearchNeighbors != m_params.localSearchNeighbors);
+        bool heuristic = (params.beta != m_params.beta);
+        bool choiceInfo = heuristic || (params.alpha != m_params.alpha);
+        bool colonySystem = (params.rule == update_rule::colony_system && m_params.rule != update_rule::colony_system);
+        bool rule = (params.rule != m_params.rule);
+        bool fold = rule || (params.alpha != m_params.alpha);
+        bool population = (params.rule == update_rule::population) &&
+            (m_params.rule != update_rule::population || params.populationSize != m_params.populationSize);
+        m_params = params;
+        if (rebuild) {
+            reset();
+            return;
+        }
+
+        if (threads) {
+            resizePool();
+        }
+        if (rule) {
+            allocateDeltas();
+        }
+        if (candidates) {
+            std::visit([&](auto &graph) { buildCandidates(graph); }, m_graph);
+        }
+        if (heuristic) {
+            std::visit([&](auto &graph) { computeHeuristic(graph); }, m_graph);
+        }
+        // The other rules expect the real trails, and the limit
+        // of the scale depends on alpha
+        if (fold) {
+            foldScale();
+        }
+        else if (choiceInfo) {
+            computeChoiceInfo();
+        }
+        if (colonySystem) {
+            resetTrails(m_tau0);
+        }
+        if (population) {
+            resetPopulation();
+        }
+    }
+
+    void colony_solver::step() {
+        if (m_source.size() == 0 || m_colony.antsCount() == 0)
+            return;
+
+        ++m_iterations;
+
+        std::visit([&](auto &graph) {
+            constructPaths(graph);
+            improvePaths(graph);
+            updatePheromones(graph);
+        }, m_graph);
+    }
+
+    void colony_solver::run(int nSteps) {
+        for (int i = 0; i < nSteps; ++i) {
+            step();
+        }
+    }
+
+    template<typename graph_type>
+    void colony_solver::constructPaths(const graph_type &graph) {
+        // Every ant only reads the pheromones while building its path,
+        // so the ants can walk the graph at the same time
+        if (m_params.construction == construction_mode::beam) {
+            constructPathsBeam(graph);
+        }
+        else if (m_params.construction == construction_mode::backtracking) {
+            m_pool.parallelFor(m_colony.antsCount(), [&](std::size_t antIdx, uint32_t worker) {
+                ant current(m_colony, antIdx);
+                m_generators[antIdx].reseed(m_seed, antStream(m_iterations, antIdx));
+                constructPathBacktracking(graph, current, m_generators[antIdx], m_workspaces[worker]);
+            });
+        }
+        else if (m_params.rule == update_rule::colony_system) {
+            constructPathsLockstep(graph);
+        }
+        else {
+            for (auto &choices : m_choices)
+                choices.resize(graph.size());
+
+            m_pool.parallelFor(m_colony.antsCount(), [&](std::size_t antIdx, uint32_t worker) {
+                ant current(m_colony, antIdx);
+                m_generators[antIdx].reseed(m_seed, antStream(m_iterations, antIdx));
+                constructPath(graph, current, m_generators[antIdx], m_choices[worker].data());
+            });
+        }
+
+        const uint8_t *stuck = m_colony.stuck();
+        auto abandoned = std::count(stuck, stuck + m_colony.antsCount(), 2);
+        m_abandoned += abandoned;
+
+        // Abandoned ants only mean the best path is good
+        bool anyPath = std::find(stuck, stuck + m_colony.antsCount(), 0) != stuck + m_colony.antsCount();
+        if (! anyPath && abandoned == 0) {
+            logger::critical("What?? there are no paths?");
+        }
+    }
+
+    template<typename graph_type>
+    void colony_solver::constructPath(const graph_type &graph, ant &ant, random::generator &gen, double *choices) {
+        // Reset the previous state of the ant
+        // And randomly choose the starting node of the new path
+        ant.reset();
+        ant.visitNode(gen.i_zero_intMax() % graph.size());
+        double unvisitedBound = m_cheapestTotal - m_cheapestEdge[ant.currNode()];
+
+        // One draw per step, all of them at once
+        gen.fill(choices, graph.size() - 1);
+
+        // Iterate until the path of the ant is complete
+        for (int itNodes = 1; itNodes < graph.size(); ++itNodes) {
+            if (hopeless(ant, unvisitedBound)) {
+                ant.markAbandoned();
+                return;
+            }
+
+            auto edge = chooseEdge(graph, ant, choices[itNodes - 1]);
+
+            // The ant got stuck!
+            if (edge == graph.no_edge) {
+                ant.markStuck();
+                return;
+            }
+
+            // The ant visit the node
+            ant.visitNode(graph.target(edge), graph.weight(edge));
+            unvisitedBound -= m_cheapestEdge[ant.currNode()];
+        }
+
+        // A path that can't go back to the starting node isn't a cycle
+        auto closingEdge = graph.findEdge(ant.currNode(), ant.path()[0]);
+        if (closingEdge == graph.no_edge) {
+            ant.markStuck();
+            return;
+        }
+
+        ant.closePath(graph.weight(closingEdge));
+    }
+
+    template<typename graph_type>
+    void colony_solver::constructPathBacktracking(const graph_type &graph, ant &ant, random::generator &gen, backtrack_workspace &workspace) {
+        auto &excluded = workspace.excluded;
+        auto &freeDegree = workspace.freeDegree;
+        auto &inPath = workspace.inPath;
+        auto &nearFirst = workspace.nearFirst;
+
+        // The node joins or leaves the path, its neighbors lose or get back a free neighbor
+        auto setInPath = [&](graph_t::node_id node, bool value) {
+            inPath[node] = value;
+            graph.forEachNeighbor(node, [&](graph_t::node_id neighId, double, auto) {
+                freeDegree[neighId] += value ? -1 : 1;
+            });
+        };
+
+        excluded.clear();
+        freeDegree.assign(m_degrees.begin(), m_degrees.end());
+        inPath.assign(graph.size(), 0);
+        nearFirst.assign(graph.size(), 0);
+
+        ant.reset();
+        ant.visitNode(gen.i_zero_intMax() % graph.size());
+        double unvisitedBound = m_cheapestTotal - m_cheapestEdge[ant.currNode()];
+        int backtracks = 0;
+
+        setInPath(ant.currNode(), true);
+        graph.forEachNeighbor(ant.currNode(), [&](graph_t::node_id neighId, double, auto) {
+            nearFirst[neighId] = 1;
+        });
+
+        while (ant.pathSize() < graph.size()) {
+            if (hopeless(ant, unvisitedBound)) {
+                ant.markAbandoned();
+                return;
+            }
+
+            auto edge = chooseEdge(graph, ant, gen.f_zero_to_one());
+
+            if (edge != graph.no_edge) {
+                auto next = graph.target(edge);
+
+                // A move that cuts the nodes left is never tried again from here
+                if (! keepsCycle(graph, ant, next, workspace)) {
+                    ant.excludeNode(next);
+                    excluded.push_back(next);
+                    continue;
+                }
+
+                // Somewhere else the excluded nodes are fine again
+                for (auto node : excluded)
+                    ant.forgetNode(node);
+                excluded.clear();
+
+                ant.visitNode(next, graph.weight(edge));
+                setInPath(next, true);
+                unvisitedBound -= m_cheapestEdge[next];
+                continue;
+            }
+
+            // Dead end, the ant steps back and its current node is
+            // excluded from the previous one. Stamps don't matter once stuck,
+            // the next reset starts a new epoch
+            if (ant.pathSize() == 1 || backtracks >= m_params.backtrackLimit) {
+                ant.markStuck();
+                return;
+            }
+            ++backtracks;
+
+            for (auto node : excluded)
+                ant.forgetNode(node);
+            excluded.clear();
+
+            auto last = ant.currNode();
+            auto prev = ant.path()[ant.pathSize() - 2];
+            ant.popNode(graph.weight(graph.findEdge(prev, last)));
+            setInPath(last, false);
+            excluded.push_back(last);
+            unvisitedBound += m_cheapestEdge[last];
+        }
+
+        // The last move already made sure the path can close
+        auto closingEdge = graph.findEdge(ant.currNode(), ant.path()[0]);
+        if (closingEdge == graph.no_edge) {
+            ant.markStuck();
+            return;
+        }
+
+        ant.closePath(graph.weight(closingEdge));
+    }
+
+    template<typename graph_type>
+    bool colony_solver::keepsCycle(const graph_type &graph, const ant &ant, graph_t::node_id next, backtrack_workspace &workspace) const {
+        const auto &freeDegree = workspace.freeDegree;
+        const auto &inPath = workspace.inPath;
+        const auto &nearFirst = workspace.nearFirst;
+
+        auto first = ant.path()[0];
+        auto last = ant.currNode();
+        auto remaining = graph.size() - ant.pathSize() - 1;
+
+        if (remaining == 0)
+            return graph.findEdge(next, first) != graph.no_edge;
+
+        // Both ends of the rest of the path need a node left to go to
+        if (freeDegree[next] == 0 || freeDegree[first] - nearFirst[next] == 0)
+            return false;
+
+        // The cycle enters and leaves every node left through nodes left, the
+        // end of the path or the first node. The neighbors of next swap it
+        // as a free neighbor for the new end, only the neighbors of the
+        // current end lose one, it's in the path and not the end anymore
+        if (last != first) {
+            bool cut = false;
+            graph.forEachNeighbor(last, [&](graph_t::node_id neighId, double, auto) {
+                if (! inPath[neighId] && neighId != next && freeDegree[neighId] + nearFirst[neighId] < 2)
+                    cut = true;
+            });
+            if (cut)
+                return false;
+        }
+
+        // The nodes left were connected, without next they can only
+        // split when next joins at least two of them
+        return freeDegree[next] < 2 || staysConnected(graph, next, workspace);
+    }
+
+    template<typename graph_type>
+    bool colony_solver::staysConnected(const graph_type &graph, graph_t::node_id removed, backtrack_workspace &workspace) const {
+        const auto &inPath = workspace.inPath;
+        auto &marks = workspace.marks;
+        auto &searches = workspace.searches;
+        auto &queues = workspace.queues;
+        auto &heads = workspace.heads;
+        auto &groups = workspace.groups;
+        auto &active = workspace.active;
+
+        if (marks.size() != static_cast<std::size_t>(graph.size())) {
+            marks.assign(graph.size(), 0);
+            searches.assign(graph.size(), 0);
+            workspace.epoch = 0;
+        }
+        if (++workspace.epoch == 0) {
+            std::fill(marks.begin(), marks.end(), 0);
+            workspace.epoch = 1;
+        }
+        auto epoch = workspace.epoch;
+
+        // One search from every free neighbor of the removed node, all of
+        // them advance one node at a time and join when they meet
+        marks[removed] = epoch;
+        searches[removed] = -1;
+
+        int32_t nSearches = 0;
+        graph.forEachNeighbor(removed, [&](graph_t::node_id neighId, double, auto) {
+            if (inPath[neighId])
+                return;
+            if (static_cast<int32_t>(queues.size()) == nSearches)
+                queues.emplace_back();
+            queues[nSearches].assign(1, neighId);
+            marks[neighId] = epoch;
+            searches[neighId] = nSearches++;
+        });
+
+        heads.assign(nSearches, 0);
+        groups.resize(nSearches);
+        std::iota(groups.begin(), groups.end(), 0);
+        active.assign(nSearches, 1);
+        int32_t nGroups = nSearches;
+
+        auto root = [&](int32_t search) {
+            while (groups[search] != search)
+                search = groups[search] = groups[groups[search]];
+            return search;
+        };
+
+        // All of them join before long if the nodes are still connected,
+        // otherwise the smaller side runs out of nodes first
+        while (true) {
+            for (int32_t search = 0; search < nSearches; ++search) {
+                auto &queue = queues[search];
+                if (heads[search] == queue.size())
+                    continue;
+
+                auto node = queue[heads[search]++];
+                graph.forEachNeighbor(node, [&](graph_t::node_id neighId, double, auto) {
+                    if (inPath[neighId])
+                        return;
+
+                    if (marks[neighId] != epoch) {
+                        marks[neighId] = epoch;
+                        searches[neighId] = search;
+                        queue.push_back(neighId);
+                        return;
+                    }
+
+                    if (searches[neighId] < 0)
+                        return;
+
+                    auto rootA = root(search);
+                    auto rootB = root(searches[neighId]);
+                    if (rootA != rootB) {
+                        groups[rootB] = rootA;
+                        active[rootA] += active[rootB];
+                        --nGroups;
+                    }
+                });
+
+                if (nGroups == 1)
+                    return true;
+
+                if (heads[search] == queue.size() && --active[root(search)] == 0)
+                    return false;
+            }
+        }
+    }
+
+    template<typename graph_type>
+    void colony_solver::constructPathsLockstep(const graph_type &graph) {
+        auto nAnts = m_colony.antsCount();
+        m_unvisitedBounds.resize(nAnts);
+
+        m_pool.parallelFor(nAnts, [&](std::size_t antIdx, uint32_t) {
+            ant current(m_colony, antIdx);
+            m_generators[antIdx].reseed(m_seed, antStream(m_iterations, antIdx));
+            current.reset();
+            current.visitNode(m_generators[antIdx].i_zero_intMax() % graph.size());
+            m_unvisitedBounds[antIdx] = m_cheapestTotal - m_cheapestEdge[current.currNode()];
+        });
+
+        for (int itNodes = 1; itNodes < graph.size(); ++itNodes) {
+            // The ants only read the trails while choosing their next node...
+            m_pool.parallelFor(nAnts, [&](std::size_t antIdx, uint32_t) {
+                ant current(m_colony, antIdx);
+                if (current.stuck()) return;
+
+                if (hopeless(current, m_unvisitedBounds[antIdx])) {
+                    current.markAbandoned();
+                    return;
+                }
+
+                auto edge = chooseEdge(graph, current, m_generators[antIdx].f_zero_to_one());
+                if (edge == graph.no_edge) {
+                    current.markStuck();
+                    return;
+                }
+                current.visitNode(graph.target(edge), graph.weight(edge));
+                m_unvisitedBounds[antIdx] -= m_cheapestEdge[current.currNode()];
+            });
+
+            // ...and wear them once all of them moved
+            for (int32_t antIdx = 0; antIdx < nAnts; ++antIdx) {
+                ant current(m_colony, antIdx);
+                if (! current.stuck())
+                    localUpdate(graph, current.path()[itNodes - 1], current.path()[itNodes]);
+            }
+        }
+
+        for (int32_t antIdx = 0; antIdx < nAnts; ++antIdx) {
+            ant current(m_colony, antIdx);
+            if (current.stuck())
+                continue;
+
+            auto closingEdge = graph.findEdge(current.currNode(), current.path()[0]);
+            if (closingEdge == graph.no_edge) {
+                current.markStuck();
+                continue;
+            }
+
+            current.closePath(graph.weight(closingEdge));
+            localUpdate(graph, current.currNode(), current.path()[0]);
+        }
+    }
+
+    template<typename graph_type>
+    void colony_solver::constructPathsBeam(const graph_type &graph) {
+        auto width = m_colony.antsCount();
+        auto nExtensions = std::max(m_params.beamExtensions, 1);
+
+        if (m_beam.antsCount() != width || m_beam.nodesCount() != graph.size())
+            m_beam.resize(width, graph.size());
+        m_extensions.resize(static_cast<std::size_t>(width) * nExtensions);
+        m_extensionOrder.resize(m_extensions.size());
+        m_unvisitedBounds.resize(width);
+        m_nextUnvisitedBounds.resize(width);
+
+        // Partial path i of the beam samples with stream i
+        for (int32_t antIdx = 0; antIdx < width; ++antIdx) {
+            m_generators[antIdx].reseed(m_seed, antStream(m_iterations, antIdx));
+        }
+
+        // The beam starts as a single path at a random node
+        ant root(m_colony, 0);
+        root.reset();
+        root.visitNode(m_generators[0].i_zero_intMax() % graph.size());
+        m_unvisitedBounds[0] = m_cheapestTotal - m_cheapestEdge[root.currNode()];
+        int32_t beamSize = 1;
+
+        for (int itNodes = 1; itNodes < graph.size() && beamSize > 0; ++itNodes) {
+            // Every partial path samples its extensions on its own...
+            m_pool.parallelFor(beamSize, [&](std::size_t parentIdx, uint32_t) {
+                ant parent(m_colony, parentIdx);
+                auto &gen = m_generators[parentIdx];
+                beam_extension *extensions = m_extensions.data() + parentIdx * nExtensions;
+
+                for (int32_t it = 0; it < nExtensions; ++it) {
+                    auto edge = chooseEdge(graph, parent, gen.f_zero_to_one());
+                    bool repeated = std::any_of(extensions, extensions + it, [&](auto &other) { return other.edge == edge; });
+
+                    double bound = graph_t::inf;
+                    if (edge != graph.no_edge && ! repeated)
+                        bound = parent.distanceTraveled() + graph.weight(edge) + m_unvisitedBounds[parentIdx];
+                    extensions[it] = { static_cast<int32_t>(parentIdx), edge, bound };
+                }
+            });
+
+            // ...and only the best width of all of them survive, ties go to
+            // the lower index so the beam doesn't depend on the threads
+            int32_t nValid = 0;
+            for (int32_t it = 0; it < beamSize * nExtensions; ++it) {
+                if (m_extensions[it].bound != graph_t::inf)
+                    m_extensionOrder[nValid++] = it;
+            }
+
+            auto nextSize = std::min(nValid, width);
+            std::partial_sort(m_extensionOrder.begin(), m_extensionOrder.begin() + nextSize, m_extensionOrder.begin() + nValid, [&](int32_t lhs, int32_t rhs) {
+                if (m_extensions[lhs].bound != m_extensions[rhs].bound)
+                    return m_extensions[lhs].bound < m_extensions[rhs].bound;
+                return lhs < rhs;
+            });
+
+            m_pool.parallelFor(nextSize, [&](std::size_t childIdx, uint32_t) {
+                const auto &extension = m_extensions[m_extensionOrder[childIdx]];
+                auto target = graph.target(extension.edge);
+
+                m_beam.copyAnt(m_colony, extension.parent, childIdx);
+                ant(m_beam, childIdx).visitNode(target, graph.weight(extension.edge));
+                m_nextUnvisitedBounds[childIdx] = m_unvisitedBounds[extension.parent] - m_cheapestEdge[target];
+            });
+
+            m_colony.swap(m_beam);
+            std::swap(m_unvisitedBounds, m_nextUnvisitedBounds);
+            beamSize = nextSize;
+        }
+
+        // The complete paths of the beam are the paths of the iteration,
+        // the rest of the ants have none
+        for (int32_t antIdx = 0; antIdx < width; ++antIdx) {
+            ant current(m_colony, antIdx);
+            if (antIdx >= beamSize) {
+                current.reset();
+                current.markStuck();
+                continue;
+            }
+
+            auto closingEdge = graph.findEdge(current.currNode(), current.path()[0]);
+            if (closingEdge == graph.no_edge) {
+                current.markStuck();
+                continue;
+            }
+            current.closePath(graph.weight(closingEdge));
+        }
+    }
+
+    bool colony_solver::hopeless(const ant &ant, double unvisitedBound) const {
+        // The rest of the cycle leaves the current node and every unvisited one once
+        return m_params.pruneAnts &&
+            ant.partialLength() + m_cheapestEdge[ant.currNode()] + unvisitedBound >= m_bestPathLength;
+    }
+
+    template<typename graph_type>
+    std::size_t colony_solver::chooseEdge(const graph_type &graph, const ant &ant, double choice) const {
+        auto currNode = ant.currNode();
+
+        // ACS takes the best edge when the choice is below q0,
+        // otherwise the rest of the range is stretched back to [0, 1)
+        bool exploit = false;
+        if (m_params.rule == update_rule::colony_system) {
+            exploit = choice < m_params.q0;
+            if (! exploit)
+                choice = (choice - m_params.q0) / (1.0 - m_params.q0);
+        }
+
+        // The closest neighbors first, everything else only if they were all visited.
+        // The probability of a node is its choice info over the total of the unvisited ones
+        const candidate *candidates = m_candidates.data() + static_cast<std::size_t>(currNode) * m_candidatesStride;
+        auto nCandidates = std::min(m_candidatesCount[currNode], m_params.nCandidates);
+        std::size_t chosenEdge = graph.no_edge;
+
+        if (exploit) {
+            double bestInfo = 0.0;
+            for (int32_t i = 0; i < nCandidates; ++i) {
+                if (! ant.isVisited(candidates[i].node) && m_choiceInfo[candidates[i].edge] > bestInfo) {
+                    bestInfo = m_choiceInfo[candidates[i].edge];
+                    chosenEdge = candidates[i].edge;
+                }
+            }
+
+            if (chosenEdge != graph.no_edge)
+                return chosenEdge;
+
+            if constexpr (std::is_same_v<graph_type, dense_graph_t>) {
+                auto chosen = argmaxSelect(m_choiceInfo.data() + graph.edgeId(currNode, 0), ant.visitStamps(), ant.epoch(), graph.size());
+                return chosen == -1 ? graph.no_edge : graph.edgeId(currNode, chosen);
+            }
+            else {
+                for (auto edge = graph.edgesBegin(currNode); edge < graph.edgesEnd(currNode); ++edge) {
+                    if (! ant.isVisited(graph.target(edge)) && m_choiceInfo[edge] > bestInfo) {
+                        bestInfo = m_choiceInfo[edge];
+                        chosenEdge = edge;
+                    }
+                }
+                return chosenEdge;
+            }
+        }
+
+        double probTotal = 0.0;
+        for (int32_t i = 0; i < nCandidates; ++i) {
+            if (! ant.isVisited(candidates[i].node))
+                probTotal += m_choiceInfo[candidates[i].edge];
+        }
+
+        if (probTotal > 0.0) {
+            double target = choice * probTotal;
+            double prob = 0.0;
+            for (int32_t i = 0; i < nCandidates; ++i) {
+                if (ant.isVisited(candidates[i].node))
+                    continue;
+                prob += m_choiceInfo[candidates[i].edge];
+                chosenEdge = candidates[i].edge;
+                if (prob > target)
+                    break;
+            }
+        }
+        else if constexpr (std::is_same_v<graph_type, dense_graph_t>) {
+            // The whole row of the matrix, the node id is the index in it
+            auto chosen = rouletteSelect(m_choiceInfo.data() + graph.edgeId(currNode, 0), ant.visitStamps(), ant.epoch(), graph.size(), choice);
+            if (chosen != -1)
+                chosenEdge = graph.edgeId(currNode, chosen);
+        }
+        else {
+            for (auto edge = graph.edgesBegin(currNode); edge < graph.edgesEnd(currNode); ++edge) {
+                if (! ant.isVisited(graph.target(edge)))
+                    probTotal += m_choiceInfo[edge];
+            }
+
+            double target = choice * probTotal;
+            double prob = 0.0;
+            for (auto edge = graph.edgesBegin(currNode); edge < graph.edgesEnd(currNode) && probTotal > 0.0; ++edge) {
+                if (ant.isVisited(graph.target(edge)) || m_choiceInfo[edge] <= 0.0)
+                    continue;
+                prob += m_choiceInfo[edge];
+                chosenEdge = edge;
+                if (prob > target)
+                    break;
+            }
+        }
+
+        return chosenEdge;
+    }
+
+    template<typename graph_type>
+    void colony_solver::localUpdate(const graph_type &graph, graph_t::node_id node_A, graph_t::node_id node_B) {
+        for (auto edge : { graph.edgeId(node_A, node_B), graph.edgeId(node_B, node_A) }) {
+            m_pheromones[edge] = (1.0 - m_params.xi) * m_pheromones[edge] + m_params.xi * m_tau0;
+            m_choiceInfo[edge] = std::pow(m_pheromones[edge], m_params.alpha) * m_heuristic[edge];
+        }
+    }
+
+    template<typename graph_type>
+    void colony_solver::improvePaths(const graph_type &graph) {
+        if (m_params.localSearch == local_search::none)
+            return;
+
+        neighbor_lists neighbors{ m_candidates.data(), m_candidatesCount.data(), m_candidatesStride, m_params.localSearchNeighbors };
+        bool twoLevelList = m_params.localSearchListNodes > 0 && graph.size() >= m_params.localSearchListNodes;
+        double *lengths = m_colony.lengths();
+
+        if (m_params.localSearchBestOnly) {
+            int32_t chosenPath = -1;
+            double minPath = graph_t::inf;
+            for (int32_t antIdx = 0; antIdx < m_colony.antsCount(); ++antIdx) {
+                auto pathLength = ant(m_colony, antIdx).distanceTraveled();
+                if (pathLength < minPath) {
+                    minPath = pathLength;
+                    chosenPath = antIdx;
+                }
+            }
+
+            if (chosenPath != -1) {
+                lengths[chosenPath] += m_optimizers[0].improve(graph, m_params.localSearch, m_colony.path(chosenPath), graph.size(), neighbors, twoLevelList);
+            }
+            return;
+        }
+
+        // Each ant only changes its own path
+        m_pool.parallelFor(m_colony.antsCount(), [&](std::size_t antIdx, uint32_t worker) {
+            if (m_colony.stuck()[antIdx]) return;
+            lengths[antIdx] += m_optimizers[worker].improve(graph, m_params.localSearch, m_colony.path(antIdx), graph.size(), neighbors, twoLevelList);
+        });
+    }
+
+    template<typename graph_type>
+    void colony_solver::updatePheromones(const graph_type &graph) {
+        // Save the best path
+        int32_t chosenPath = -1;
+        double minPath = graph_t::inf;
+
+        for (int32_t antIdx = 0; antIdx < m_colony.antsCount(); ++antIdx) {
+            auto pathLength = ant(m_colony, antIdx).distanceTraveled();
+            if (pathLength < minPath) {
+                minPath = pathLength;
+                chosenPath = antIdx;
+            }
+        }
+
+        // If the best path found on this iteration
+        // is better than the already found update it
+        if (minPath < m_bestPathLength) {
+            ant best(m_colony, chosenPath);
+            m_bestPathLength = minPath;
+            m_bestPath.assign(best.path(), best.path() + best.pathSize());
+            m_lastImprovement = m_iterations;
+        }
+
+        m_iterationBestLength = minPath;
+
+        // ACS only touches the edges of the global best, the rest
+        // of the trails only change when the ants cross them
+        if (m_params.rule == update_rule::colony_system) {
+            auto lIt = m_bestPath.empty() ? 0 : m_bestPath.back();
+            for (auto it : m_bestPath) {
+                for (auto edge : { graph.edgeId(lIt, it), graph.edgeId(it, lIt) }) {
+                    m_pheromones[edge] = (1.0 - m_params.rho) * m_pheromones[edge] + m_params.rho / m_bestPathLength;
+                    m_choiceInfo[edge] = std::pow(m_pheromones[edge], m_params.alpha) * m_heuristic[edge];
+                    m_maxPheromone = std::max(m_maxPheromone, m_pheromones[edge]);
+                }
+                lIt = it;
+            }
+            return;
+        }
+
+        // P-ACO only changes the edges of the paths entering and leaving the population
+        if (m_params.rule == update_rule::population) {
+            updatePopulation(graph, chosenPath);
+            return;
+        }
+
+        // Without bounds every trail vanishes by the same factor, so that's
+        // only m_scale and the ants deposit straight into the trails,
+        // the cost is the length of the deposited paths instead of the edges
+        bool lazy = lazyEvaporation();
+        if (lazy) {
+            m_scale *= 1.0 - m_params.rho;
+            if (m_scale < minScale())
+                foldScale();
+        }
+
+        // The ants leave pheromones based on the total length
+        // of their paths, m_deltas is all zeros at this point
+        bool bounded = false;
+        switch (m_params.rule) {
+            case update_rule::max_min: {
+                // Only one of the best paths, the global one from time to time
+                // or when every ant of this iteration got stuck
+                bool useGlobal = chosenPath == -1 ||
+                    (m_params.globalBestPeriod > 0 && m_iterations % m_params.globalBestPeriod == 0);
+
+                if (useGlobal && ! m_bestPath.empty()) {
+                    depositPath(graph, m_bestPath.data(), static_cast<int32_t>(m_bestPath.size()), 1.0 / m_bestPathLength);
+                }
+                else if (chosenPath != -1) {
+                    ant best(m_colony, chosenPath);
+                    depositPath(graph, best.path(), best.pathSize(), 1.0 / minPath);
+                }
+
+                updateBounds();
+                bounded = ! m_bestPath.empty();
+                break;
+            }
+
+            case update_rule::elitist:
+                depositAll(graph);
+                if (! m_bestPath.empty()) {
+                    depositPath(graph, m_bestPath.data(), static_cast<int32_t>(m_bestPath.size()), m_params.elitistWeight / m_bestPathLength);
+                }
+                break;
+
+            case update_rule::rank_based:
+                depositRanked(graph);
+                break;
+
+            default:
+                depositAll(graph);
+                break;
+        }
+
+        if (lazy)
+            return;
+
+        // 'Vanish' the old pheromones and add the new ones in one pass,
+        // edges that don't exist have 0 pheromones so they stay that way.
+        // The deltas are cleared on the way for the next iteration
+        // and the choice info is refreshed with the new pheromones
+        std::vector<double> workerMax(m_pool.size(), std::numeric_limits<double>::min());
+        double keep = 1.0 - m_params.rho;
+
+        m_pool.parallelForRange(m_pheromones.size(), 1 << 14, [&](std::size_t first, std::size_t last, uint32_t worker) {
+            double maxPheromone = workerMax[worker];
+
+            for (std::size_t edge = first; edge < last; ++edge) {
+                m_pheromones[edge] = keep * m_pheromones[edge] + m_deltas[edge];
+                m_deltas[edge] = 0.0;
+                if (bounded && m_heuristic[edge] > 0.0)
+                    m_pheromones[edge] = std::clamp(m_pheromones[edge], m_tauMin, m_tauMax);
+                m_choiceInfo[edge] = std::pow(m_pheromones[edge], m_params.alpha) * m_heuristic[edge];
+                maxPheromone = std::max(maxPheromone, m_pheromones[edge]);
+            }
+
+            workerMax[worker] = maxPheromone;
+        });
+
+        m_maxPheromone = *std::max_element(workerMax.begin(), workerMax.end());
+
+        // The ants keep walking the same paths, start over from the upper bound
+        if (bounded && m_params.stagnationLimit > 0 && m_iterations - m_lastImprovement >= m_params.stagnationLimit) {
+            reinitializeTrails();
+        }
+    }
+
+    template<typename graph_type>
+    void colony_solver::depositPath(const graph_type &graph, const graph_t::node_id *path, int32_t pathSize, double amount) {
+        auto lIt = path[pathSize - 1];
+
+        if (! directDeposits()) {
+            for (int32_t it = 0; it < pathSize; ++it) {
+                m_deltas[graph.edgeId(lIt, path[it])] += amount;
+                m_deltas[graph.edgeId(path[it], lIt)] += amount;
+                lIt = path[it];
+            }
+            return;
+        }
+
+        // The trails are stored divided by m_scale. The choice info
+        // uses them as they are, the probabilities don't change when
+        // every trail is scaled by the same factor
+        amount /= m_scale;
+        for (int32_t it = 0; it < pathSize; ++it) {
+            for (auto edge : { graph.edgeId(lIt, path[it]), graph.edgeId(path[it], lIt) }) {
+                m_pheromones[edge] += amount;
+                m_choiceInfo[edge] = std::pow(m_pheromones[edge], m_params.alpha) * m_heuristic[edge];
+                m_maxPheromone = std::max(m_maxPheromone, m_pheromones[edge]);
+            }
+            lIt = path[it];
+        }
+    }
+
+    bool colony_solver::lazyEvaporation() const {
+        // MAX-MIN clamps every trail on its own, ACS doesn't evaporate globally
+        return m_params.rule != update_rule::max_min && m_params.rule != update_rule::colony_system;
+    }
+
+    bool colony_solver::directDeposits() const {
+        return lazyEvaporation() || m_params.rule == update_rule::population;
+    }
+
+    double colony_solver::minScale() const {
+        // The stored trails grow as 1 / m_scale and the choice info as
+        // their power alpha, it has to stay far from overflowing
+        return std::exp2(-256.0 / std::max(m_params.alpha, 1.0));
+    }
+
+    void colony_solver::foldScale() {
+        m_pool.parallelForRange(m_pheromones.size(), 1 << 14, [&](std::size_t first, std::size_t last, uint32_t) {
+            for (std::size_t edge = first; edge < last; ++edge) {
+                m_pheromones[edge] *= m_scale;
+            }
+        });
+        m_maxPheromone *= m_scale;
+        m_scale = 1.0;
+
+        computeChoiceInfo();
+    }
+
+    template<typename graph_type>
+    void colony_solver::depositAll(const graph_type &graph) {
+        // In the order of the ants, the floating point sums depend on it
+        for (int32_t antIdx = 0; antIdx < m_colony.antsCount(); ++antIdx) {
+            ant current(m_colony, antIdx);
+
+            // Stuck ants don't leave pheromones
+            if (current.stuck()) continue;
+
+            depositPath(graph, current.path(), current.pathSize(), 1.0 / current.distanceTraveled());
+        }
+    }
+
+    template<typename graph_type>
+    void colony_solver::depositRanked(const graph_type &graph) {
+        auto nRanked = std::clamp(m_params.rankedAnts - 1, 0, m_colony.antsCount());
+
+        // Only the first nRanked positions need to be in order,
+        // stuck ants go after every ant that made a cycle
+        const double *lengths = m_colony.lengths();
+        const uint8_t *stuck = m_colony.stuck();
+        std::iota(m_ranking.begin(), m_ranking.end(), 0);
+        std::partial_sort(m_ranking.begin(), m_ranking.begin() + nRanked, m_ranking.end(), [&](int32_t lhs, int32_t rhs) {
+            if (stuck[lhs] != stuck[rhs])
+                return stuck[lhs] < stuck[rhs];
+            return lengths[lhs] < lengths[rhs];
+        });
+
+        for (int32_t rank = 0; rank < nRanked; ++rank) {
+            ant current(m_colony, m_ranking[rank]);
+            if (current.stuck()) continue;
+
+            double weight = nRanked - static_cast<double>(rank);
+            depositPath(graph, current.path(), current.pathSize(), weight / current.distanceTraveled());
+        }
+
+        if (! m_bestPath.empty()) {
+            depositPath(graph, m_bestPath.data(), static_cast<int32_t>(m_bestPath.size()), std::max(m_params.rankedAnts, 1) / m_bestPathLength);
+        }
+    }
+
+    void colony_solver::resetPopulation() {
+        auto nNodes = m_colony.nodesCount();
+        auto size = std::max(m_params.populationSize, 1);
+
+        m_population.assign(static_cast<std::size_t>(size) * nNodes, 0);
+        m_populationHead = 0;
+        m_populationCount = 0;
+
+        // Guntsch & Middendorf: the trails start at 1 / (n - 1) and
+        // reach 1 on the edges shared by the whole population
+        resetTrails(nNodes > 1 ? 1.0 / (nNodes - 1) : 1.0);
+    }
+
+    template<typename graph_type>
+    void colony_solver::updatePopulation(const graph_type &graph, int32_t chosenPath) {
+        // Every ant got stuck, the population stays as it is
+        if (chosenPath == -1)
+            return;
+
+        auto nNodes = graph.size();
+        auto size = std::max(m_params.populationSize, 1);
+        double base = nNodes > 1 ? 1.0 / (nNodes - 1) : 1.0;
+        double share = (1.0 - base) / size;
+
+        // The oldest path leaves first when the population is full
+        if (m_populationCount == size) {
+            depositPath(graph, m_population.data() + static_cast<std::size_t>(m_populationHead) * nNodes, nNodes, -share);
+            m_populationHead = (m_populationHead + 1) % size;
+            --m_populationCount;
+        }
+
+        auto *slot = m_population.data() + static_cast<std::size_t>((m_populationHead + m_populationCount) % size) * nNodes;
+        ant best(m_colony, chosenPath);
+        std::copy(best.path(), best.path() + nNodes, slot);
+        ++m_populationCount;
+
+        depositPath(graph, slot, nNodes, share);
+    }
+
+    void colony_solver::updateBounds() {
+        if (m_bestPath.empty())
+            return;
+
+        // tauMax is the limit of the trails of the best path, tauMin makes the
+        // chance of building it again pBest once everything else is at tauMin,
+        // with avg choices per step on average (Stützle & Hoos)
+        auto n = static_cast<double>(m_bestPath.size());
+        double pDec = std::pow(m_params.pBest, 1.0 / n);
+        double avg = n / 2.0;
+
+        m_tauMax = 1.0 / (std::max(m_params.rho, math::constants::EPS) * m_bestPathLength);
+        m_tauMin = avg > 1.0 ? m_tauMax * (1.0 - pDec) / ((avg - 1.0) * pDec) : m_tauMax;
+        m_tauMin = std::min(m_tauMin, m_tauMax);
+    }
+
+    void colony_solver::reinitializeTrails() {
+        resetTrails(m_tauMax);
+        m_lastImprovement = m_iterations;
+        ++m_restarts;
+    }
+
+    void colony_solver::resetTrails(double level) {
+        m_scale = 1.0;
+
+        // Only the edges that exist have some heuristic
+        m_pool.parallelForRange(m_pheromones.size(), 1 << 14, [&](std::size_t first, std::size_t last, uint32_t) {
+            for (std::size_t edge = first; edge < last; ++edge) {
+                if (m_heuristic[edge] > 0.0)
+                    m_pheromones[edge] = level;
+            }
+        });
+        computeChoiceInfo();
+
+        m_maxPheromone = level;
+    }
+
+    template<typename graph_type>
+    void colony_solver::initialTrail(const graph_type &graph) {
+        m_tau0 = 1.0;
+        if (graph.size() == 0)
+            return;
+
+        // Greedy path from the first node, always to the closest unvisited neighbor
+        std::vector<bool> visited(graph.size(), false);
+        graph_t::node_id node = 0;
+        double length = 0.0;
+        visited[node] = true;
+
+        for (int itNodes = 1; itNodes < graph.size() && length != graph_t::inf; ++itNodes) {
+            graph_t::node_id next = -1;
+            double nextWeight = graph_t::inf;
+            graph.forEachNeighbor(node, [&](graph_t::node_id neighId, double neighWeight, auto) {
+                if (! visited[neighId] && neighWeight < nextWeight) {
+                    next = neighId;
+                    nextWeight = neighWeight;
+                }
+            });
+
+            if (next == -1) {
+                length = graph_t::inf;
+                break;
+            }
+
+            visited[next] = true;
+            length += nextWeight;
+            node = next;
+        }
+
+        auto closingEdge = graph.findEdge(node, 0);
+        if (length != graph_t::inf && closingEdge != graph.no_edge) {
+            length += graph.weight(closingEdge);
+        }
+        else {
+            // The greedy path got trapped, the cheapest edge of every node is close enough
+            length = 0.0;
+            for (graph_t::node_id it = 0; it < graph.size(); ++it) {
+                double cheapest = 0.0;
+                graph.forEachNeighbor(it, [&](graph_t::node_id, double neighWeight, auto) {
+                    if (cheapest == 0.0 || neighWeight < cheapest)
+                        cheapest = neighWeight;
+                });
+                length += cheapest;
+            }
+        }
+
+        if (length > 0.0)
+            m_tau0 = 1.0 / (graph.size() * length);
+    }
+
+    const colony_solver::path_t& colony_solver::best() const {
+        return m_bestPath;
+    }
+
+    double colony_solver::bestLength() const {
+        return m_bestPathLength;
+    }
+
+    double colony_solver::iterationBestLength() const {
+        return m_iterationBestLength;
+    }
+
+    double colony_solver::pheromone(graph_t::node_id node_A, graph_t::node_id node_B) const {
+        return std::visit([&](auto &graph) {
+            auto edge = graph.findEdge(node_A, node_B);
+            if (edge == graph.no_edge)
+                return graph_t::inf;
+            return m_pheromones[edge] * m_scale;
+        }, m_graph);
+    }
+
+    double colony_solver::maxPheromone() const {
+        return m_maxPheromone * m_scale;
+    }
+
+    double colony_solver::tauMin() const {
+        return m_tauMin;
+    }
+
+    double colony_solver::tauMax() const {
+        return m_tauMax;
+    }
+
+    int colony_solver::restarts() const {
+        return m_restarts;
+    }
+
+    int64_t colony_solver::abandonedAnts() const {
+        return m_abandoned;
+    }
+
+    const colony_params& colony_solver::params() const {
+        return m_params;
+    }
+
+    uint64_t colony_solver::seed() const {
+        return m_seed;
+    }
+
+    int colony_solver::iterations() const {
+        return m_iterations;
+    }
+
+    bool colony_solver::isDense() const {
+        return std::holds_alternative<dense_graph_t>(m_graph);
+    }
+
+}
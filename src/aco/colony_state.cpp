@@ -0,0 +1,159 @@
+#include <aco/colony_state.hpp>
+
+#include <cstring>
+#include <utility>
+
+namespace arti::aco {
+
+    // Smallest multiple of cacheLine bytes that holds count elements of size bytes
+    static std::size_t alignedBytes(std::size_t count, std::size_t size, std::size_t cacheLine) {
+        return (count * size + cacheLine - 1) / cacheLine * cacheLine;
+    }
+
+    colony_state::colony_state()
+      : m_capacity(0),
+        m_nAnts(0),
+        m_nNodes(0),
+        m_pathStride(0),
+        m_visitedStride(0),
+        m_paths(nullptr),
+        m_visited(nullptr),
+        m_pathSizes(nullptr),
+        m_lengths(nullptr),
+        m_epochs(nullptr),
+        m_stuck(nullptr) {
+
+    }
+
+    void colony_state::resize(int32_t nAnts, int32_t nNodes) {
+        std::size_t ants = static_cast<std::size_t>(nAnts);
+
+        // A path holds the whole cycle, the starting node can be repeated at the end
+        std::size_t pathBytes = alignedBytes(static_cast<std::size_t>(nNodes) + 1, sizeof(graph_t::node_id), cacheLine);
+        std::size_t visitedBytes = alignedBytes(static_cast<std::size_t>(nNodes), sizeof(uint32_t), cacheLine);
+
+        std::size_t pathsSize = ants * pathBytes;
+        std::size_t visitedSize = ants * visitedBytes;
+        std::size_t pathSizesSize = alignedBytes(ants, sizeof(int32_t), cacheLine);
+        std::size_t lengthsSize = alignedBytes(ants, sizeof(double), cacheLine);
+        std::size_t epochsSize = alignedBytes(ants, sizeof(uint32_t), cacheLine);
+        std::size_t stuckSize = alignedBytes(ants, sizeof(uint8_t), cacheLine);
+
+        std::size_t required = pathsSize + visitedSize + pathSizesSize + lengthsSize + epochsSize + stuckSize + cacheLine;
+
+        if (required > m_capacity) {
+            m_arena.reset(new std::byte[required]);
+            m_capacity = required;
+        }
+
+        // Align the start of the arena to a cache line
+        auto address = reinterpret_cast<std::uintptr_t>(m_arena.get());
+        std::byte *cursor = m_arena.get() + ((cacheLine - address % cacheLine) % cacheLine);
+
+        m_paths = reinterpret_cast<graph_t::node_id*>(cursor);
+        cursor += pathsSize;
+        m_visited = reinterpret_cast<uint32_t*>(cursor);
+        cursor += visitedSize;
+        m_pathSizes = reinterpret_cast<int32_t*>(cursor);
+        cursor += pathSizesSize;
+        m_lengths = reinterpret_cast<double*>(cursor);
+        cursor += lengthsSize;
+        m_epochs = reinterpret_cast<uint32_t*>(cursor);
+        cursor += epochsSize;
+        m_stuck = reinterpret_cast<uint8_t*>(cursor);
+
+        m_nAnts = nAnts;
+        m_nNodes = nNodes;
+        m_pathStride = pathBytes / sizeof(graph_t::node_id);
+        m_visitedStride = visitedBytes / sizeof(uint32_t);
+
+        // Stamps of the old layout could look like the current epoch
+        std::memset(m_visited, 0, visitedSize);
+        std::memset(m_pathSizes, 0, pathSizesSize);
+        std::memset(m_lengths, 0, lengthsSize);
+        std::memset(m_epochs, 0, epochsSize);
+        std::memset(m_stuck, 0, stuckSize);
+    }
+
+    void colony_state::swap(colony_state &other) {
+        std::swap(m_arena, other.m_arena);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_nAnts, other.m_nAnts);
+        std::swap(m_nNodes, other.m_nNodes);
+        std::swap(m_pathStride, other.m_pathStride);
+        std::swap(m_visitedStride, other.m_visitedStride);
+        std::swap(m_paths, other.m_paths);
+        std::swap(m_visited, other.m_visited);
+        std::swap(m_pathSizes, other.m_pathSizes);
+        std::swap(m_lengths, other.m_lengths);
+        std::swap(m_epochs, other.m_epochs);
+        std::swap(m_stuck, other.m_stuck);
+    }
+
+    void colony_state::copyAnt(const colony_state &from, int32_t fromAnt, int32_t toAnt) {
+        // The stamps go together with the epoch, they only mean something for it
+        std::memcpy(path(toAnt), from.path(fromAnt), from.m_pathSizes[fromAnt] * sizeof(graph_t::node_id));
+        std::memcpy(visited(toAnt), from.visited(fromAnt), m_nNodes * sizeof(uint32_t));
+        m_pathSizes[toAnt] = from.m_pathSizes[fromAnt];
+        m_lengths[toAnt] = from.m_lengths[fromAnt];
+        m_epochs[toAnt] = from.m_epochs[fromAnt];
+        m_stuck[toAnt] = from.m_stuck[fromAnt];
+    }
+
+    int32_t colony_state::antsCount() const {
+        return m_nAnts;
+    }
+
+    int32_t colony_state::nodesCount() const {
+        return m_nNodes;
+    }
+
+    graph_t::node_id* colony_state::path(int32_t ant) {
+        return m_paths + ant * m_pathStride;
+    }
+
+    const graph_t::node_id* colony_state::path(int32_t ant) const {
+        return m_paths + ant * m_pathStride;
+    }
+
+    uint32_t* colony_state::visited(int32_t ant) {
+        return m_visited + ant * m_visitedStride;
+    }
+
+    const uint32_t* colony_state::visited(int32_t ant) const {
+        return m_visited + ant * m_visitedStride;
+    }
+
+    int32_t* colony_state::pathSizes() {
+        return m_pathSizes;
+    }
+
+    double* colony_state::lengths() {
+        return m_lengths;
+    }
+
+    uint32_t* colony_state::epochs() {
+        return m_epochs;
+    }
+
+    uint8_t* colony_state::stuck() {
+        return m_stuck;
+    }
+
+    const int32_t* colony_state::pathSizes() const {
+        return m_pathSizes;
+    }
+
+    const double* colony_state::lengths() const {
+        return m_lengths;
+    }
+
+    const uint32_t* colony_state::epochs() const {
+        return m_epochs;
+    }
+
+    const uint8_t* colony_state::stuck() const {
+        return m_stuck;
+    }
+
+}
@@ -0,0 +1,341 @@
+#include <aco/local_search.hpp>
+
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+#include <math/constants.hpp>
+#include <math/dense_graph.hpp>
+#include <math/csr_graph.hpp>
+
+namespace arti::aco {
+
+    static const char* const localSearchNames[] = {
+        "none",
+        "two_opt",
+        "or_opt",
+        "three_opt"
+    };
+
+    const char* localSearchName(local_search kind) {
+        return localSearchNames[static_cast<int>(kind)];
+    }
+
+    std::optional<local_search> localSearchFromName(std::string_view name) {
+        for (int it = 0; it < static_cast<int>(std::size(localSearchNames)); ++it) {
+            if (name == localSearchNames[it])
+                return static_cast<local_search>(it);
+        }
+        return std::nullopt;
+    }
+
+    local_optimizer::local_optimizer()
+      : m_queueHead(0),
+        m_queueSize(0) {
+
+    }
+
+    template<typename graph_type>
+    double local_optimizer::improve(const graph_type &graph, local_search kind, graph_t::node_id *path, int32_t pathSize, const neighbor_lists &neighbors, bool twoLevelList) {
+        // Nothing to swap in a triangle
+        if (pathSize < 4 || kind == local_search::none)
+            return 0.0;
+
+        prepare(path, pathSize);
+
+        if (! twoLevelList) {
+            m_array.build(path, pathSize);
+            return search(graph, m_array, kind, neighbors);
+        }
+
+        m_list.build(path, pathSize);
+        double gain = search(graph, m_list, kind, neighbors);
+        if (gain < 0.0)
+            m_list.toPath(path);
+        return gain;
+    }
+
+    template<typename graph_type, typename tour_type>
+    double local_optimizer::search(const graph_type &graph, tour_type &tour, local_search kind, const neighbor_lists &neighbors) {
+        bool useTwoOpt = (kind == local_search::two_opt || kind == local_search::three_opt);
+        bool useOrOpt = (kind == local_search::or_opt || kind == local_search::three_opt);
+        bool useThreeOpt = (kind == local_search::three_opt);
+
+        double gain = 0.0;
+        while (m_queueSize > 0) {
+            auto node = pop();
+
+            double delta = 0.0;
+            if (useTwoOpt)
+                delta = tryTwoOpt(graph, tour, node, neighbors);
+            if (delta == 0.0 && useOrOpt)
+                delta = tryOrOpt(graph, tour, node, neighbors);
+            if (delta == 0.0 && useThreeOpt)
+                delta = trySegmentInsertion(graph, tour, node, neighbors);
+
+            // Maybe there's another improvement from the same node
+            if (delta < 0.0) {
+                gain += delta;
+                push(node);
+            }
+        }
+
+        return gain;
+    }
+
+    template<typename graph_type, typename tour_type>
+    double local_optimizer::tryTwoOpt(const graph_type &graph, tour_type &tour, graph_t::node_id nodeA, const neighbor_lists &neighbors) {
+        const candidate *list = neighbors.lists + static_cast<std::size_t>(nodeA) * neighbors.stride;
+        auto count = std::min(neighbors.count[nodeA], neighbors.nNeighbors);
+
+        // Replace (a, a1) and (c, c1) by (a, c) and (a1, c1), with a1 and c1
+        // both the successors or both the predecessors of a and c
+        for (int direction = 0; direction < 2; ++direction) {
+            auto nodeA1 = direction == 0 ? tour.next(nodeA) : tour.prev(nodeA);
+            double weightA = graph.getWeigth(nodeA, nodeA1);
+
+            for (int32_t i = 0; i < count; ++i) {
+                auto nodeC = list[i].node;
+                double weightAC = graph.weight(list[i].edge);
+
+                // The lists are sorted, no farther neighbor can improve the path
+                if (weightAC >= weightA)
+                    break;
+
+                auto nodeC1 = direction == 0 ? tour.next(nodeC) : tour.prev(nodeC);
+                if (nodeC == nodeA1 || nodeC1 == nodeA)
+                    continue;
+
+                double weightA1C1 = graph.getWeigth(nodeA1, nodeC1);
+                if (weightA1C1 == graph_t::inf)
+                    continue;
+
+                double delta = weightAC + weightA1C1 - weightA - graph.getWeigth(nodeC, nodeC1);
+                if (delta >= -math::constants::EPS)
+                    continue;
+
+                exchange(tour, nodeA, nodeA1, nodeC, nodeC1);
+                push(nodeA1);
+                push(nodeC);
+                push(nodeC1);
+                return delta;
+            }
+        }
+
+        return 0.0;
+    }
+
+    template<typename graph_type, typename tour_type>
+    double local_optimizer::tryOrOpt(const graph_type &graph, tour_type &tour, graph_t::node_id nodeS, const neighbor_lists &neighbors) {
+        // The segment [s, e] of up to maxSegment nodes starting at s, walking forward or
+        // backward, goes between two consecutive nodes x and y somewhere else:
+        // p [s..e] n ... x y  ->  p n ... x [s..e] y  or  p n ... x [e..s] y
+        for (int direction = 0; direction < 2; ++direction) {
+            auto next = [&](graph_t::node_id node) { return direction == 0 ? tour.next(node) : tour.prev(node); };
+            auto prev = [&](graph_t::node_id node) { return direction == 0 ? tour.prev(node) : tour.next(node); };
+
+            auto nodeP = prev(nodeS);
+            auto nodeE = nodeS;
+            auto inSegment = [&](graph_t::node_id node) {
+                return direction == 0 ? tour.between(nodeS, node, nodeE) : tour.between(nodeE, node, nodeS);
+            };
+
+            for (int32_t length = 1; length <= maxSegment; ++length) {
+                if (length > 1)
+                    nodeE = next(nodeE);
+
+                // At least p and n must be left out of the segment
+                auto nodeN = next(nodeE);
+                if (nodeE == nodeP || nodeN == nodeP)
+                    break;
+
+                double weightPN = graph.getWeigth(nodeP, nodeN);
+                if (weightPN == graph_t::inf)
+                    continue;
+
+                double removeGain = graph.getWeigth(nodeP, nodeS) + graph.getWeigth(nodeE, nodeN) - weightPN;
+                if (removeGain <= math::constants::EPS)
+                    continue;
+
+                // The new position is next to a close neighbor of one of the ends
+                for (auto end : { nodeS, nodeE }) {
+                    if (end == nodeE && length == 1)
+                        break;
+
+                    auto other = end == nodeS ? nodeE : nodeS;
+                    const candidate *list = neighbors.lists + static_cast<std::size_t>(end) * neighbors.stride;
+                    auto count = std::min(neighbors.count[end], neighbors.nNeighbors);
+
+                    for (int32_t i = 0; i < count; ++i) {
+                        auto nodeC = list[i].node;
+                        double weightC = graph.weight(list[i].edge);
+
+                        // The lists are sorted, no farther neighbor can improve the path
+                        if (weightC >= removeGain)
+                            break;
+
+                        if (inSegment(nodeC))
+                            continue;
+
+                        // c is either x or y
+                        for (int side = 0; side < 2; ++side) {
+                            auto nodeX = side == 0 ? nodeC : prev(nodeC);
+                            auto nodeY = side == 0 ? next(nodeC) : nodeC;
+                            // y == p is the same move as x == n walking the other way
+                            if (inSegment(nodeX) || inSegment(nodeY) || nodeY == nodeP)
+                                continue;
+
+                            auto endX = side == 0 ? end : other;
+                            auto endY = side == 0 ? other : end;
+
+                            double weightOther = side == 0 ? graph.getWeigth(endY, nodeY) : graph.getWeigth(nodeX, endX);
+                            if (weightOther == graph_t::inf)
+                                continue;
+
+                            double delta = weightC + weightOther - graph.getWeigth(nodeX, nodeY) - removeGain;
+                            if (delta >= -math::constants::EPS)
+                                continue;
+
+                            // p [s..e] n ... x y  ->  p x ... n [e..s] y  ->  p n ... x [e..s] y
+                            exchange(tour, nodeP, nodeS, nodeX, nodeY);
+                            exchange(tour, nodeP, nodeX, nodeN, nodeE);
+
+                            // -> p n ... x [s..e] y
+                            if (endX == nodeS && nodeS != nodeE)
+                                exchange(tour, nodeX, nodeE, nodeS, nodeY);
+
+                            push(nodeP);
+                            push(nodeN);
+                            push(nodeE);
+                            push(nodeX);
+                            push(nodeY);
+                            return delta;
+                        }
+                    }
+                }
+            }
+        }
+
+        return 0.0;
+    }
+
+    template<typename graph_type, typename tour_type>
+    double local_optimizer::trySegmentInsertion(const graph_type &graph, tour_type &tour, graph_t::node_id node1, const neighbor_lists &neighbors) {
+        // Sequential search over the neighbor lists, walking forward or backward:
+        // remove (t1, t2), add (t2, t3), remove (t3, t4), add (t4, t5), remove (t5, t6)
+        // and close with (t6, t1). With t5 between t2 and t3 the segment [t2..t5]
+        // goes between t3 and t4 as it is:
+        // t1 [t2..t5] t6 ... t3 t4  ->  t1 t6 ... t3 [t2..t5] t4
+        for (int direction = 0; direction < 2; ++direction) {
+            auto next = [&](graph_t::node_id node) { return direction == 0 ? tour.next(node) : tour.prev(node); };
+            auto between = [&](graph_t::node_id nodeA, graph_t::node_id nodeB, graph_t::node_id nodeC) {
+                return direction == 0 ? tour.between(nodeA, nodeB, nodeC) : tour.between(nodeC, nodeB, nodeA);
+            };
+
+            auto node2 = next(node1);
+            double gain1 = graph.getWeigth(node1, node2);
+
+            const candidate *list2 = neighbors.lists + static_cast<std::size_t>(node2) * neighbors.stride;
+            auto count2 = std::min(neighbors.count[node2], neighbors.nNeighbors);
+
+            for (int32_t i = 0; i < count2; ++i) {
+                auto node3 = list2[i].node;
+                double weight23 = graph.weight(list2[i].edge);
+
+                // The lists are sorted, every partial gain must stay positive
+                if (weight23 >= gain1)
+                    break;
+
+                // t4 == t1 only moves t1, which Or-opt already does
+                auto node4 = next(node3);
+                if (node3 == node1 || node4 == node1)
+                    continue;
+
+                double gain2 = gain1 - weight23 + graph.getWeigth(node3, node4);
+
+                const candidate *list4 = neighbors.lists + static_cast<std::size_t>(node4) * neighbors.stride;
+                auto count4 = std::min(neighbors.count[node4], neighbors.nNeighbors);
+
+                for (int32_t j = 0; j < count4; ++j) {
+                    auto node5 = list4[j].node;
+                    double weight45 = graph.weight(list4[j].edge);
+
+                    if (weight45 >= gain2)
+                        break;
+
+                    // The segment starts at t2 and ends before t3
+                    if (node5 == node3 || ! between(node2, node5, node3))
+                        continue;
+
+                    auto node6 = next(node5);
+                    double weight61 = graph.getWeigth(node6, node1);
+                    if (weight61 == graph_t::inf)
+                        continue;
+
+                    double delta = weight61 - graph.getWeigth(node5, node6) + weight45 - gain2;
+                    if (delta >= -math::constants::EPS)
+                        continue;
+
+                    // t1 [t2..t5] [t6..t3] t4  ->  t1 [t3..t6] [t5..t2] t4  ->  t1 [t6..t3] [t5..t2] t4
+                    // ->  t1 [t6..t3] [t2..t5] t4
+                    exchange(tour, node1, node2, node3, node4);
+                    if (node6 != node3)
+                        exchange(tour, node1, node3, node6, node5);
+                    if (node5 != node2)
+                        exchange(tour, node3, node5, node2, node4);
+
+                    push(node1);
+                    push(node2);
+                    push(node3);
+                    push(node4);
+                    push(node5);
+                    push(node6);
+                    return delta;
+                }
+            }
+        }
+
+        return 0.0;
+    }
+
+    template<typename tour_type>
+    void local_optimizer::exchange(tour_type &tour, graph_t::node_id nodeA, graph_t::node_id nodeB, graph_t::node_id nodeC, graph_t::node_id nodeD) {
+        // a b ... c d  ->  a c ... b d, or the same walking the path backwards
+        if (tour.next(nodeA) == nodeB) {
+            tour.reverse(nodeB, nodeC);
+        }
+        else {
+            tour.reverse(nodeA, nodeD);
+        }
+    }
+
+    void local_optimizer::prepare(const graph_t::node_id *path, int32_t pathSize) {
+        m_dontLook.assign(pathSize, 0);
+        m_queue.assign(path, path + pathSize);
+
+        m_queueHead = 0;
+        m_queueSize = pathSize;
+    }
+
+    void local_optimizer::push(graph_t::node_id node) {
+        if (! m_dontLook[node])
+            return;
+
+        m_dontLook[node] = 0;
+        m_queue[(m_queueHead + m_queueSize) % m_queue.size()] = node;
+        ++m_queueSize;
+    }
+
+    graph_t::node_id local_optimizer::pop() {
+        auto node = m_queue[m_queueHead];
+        m_queueHead = (m_queueHead + 1) % m_queue.size();
+        --m_queueSize;
+
+        m_dontLook[node] = 1;
+        return node;
+    }
+
+    template double local_optimizer::improve(const math::dense_graph<double>&, local_search, graph_t::node_id*, int32_t, const neighbor_lists&, bool);
+    template double local_optimizer::improve(const math::csr_graph<double>&, local_search, graph_t::node_id*, int32_t, const neighbor_lists&, bool);
+
+}
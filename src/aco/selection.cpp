@@ -0,0 +1,154 @@
+#include <aco/selection.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define ACO_SELECTION_AVX2
+    #include <immintrin.h>
+#endif
+
+namespace arti::aco {
+
+    static int32_t rouletteSelectScalar(const double *weights, const uint32_t *visited, uint32_t epoch, int32_t count, double choice) {
+        double total = 0.0;
+        for (int32_t i = 0; i < count; ++i) {
+            total += visited[i] == epoch ? 0.0 : weights[i];
+        }
+
+        if (total <= 0.0)
+            return -1;
+
+        double target = choice * total;
+        double running = 0.0;
+        int32_t last = -1;
+        for (int32_t i = 0; i < count; ++i) {
+            double weight = visited[i] == epoch ? 0.0 : weights[i];
+            if (weight > 0.0) {
+                running += weight;
+                last = i;
+                if (running > target)
+                    return i;
+            }
+        }
+
+        // Rounding may leave the prefix sum a bit short of the target
+        return last;
+    }
+
+#ifdef ACO_SELECTION_AVX2
+
+    // weights[0..3] with the visited ones set to 0
+    __attribute__((target("avx2")))
+    static inline __m256d maskedLoad(const double *weights, const uint32_t *visited, __m128i epoch) {
+        __m128i stamps = _mm_loadu_si128(reinterpret_cast<const __m128i*>(visited));
+        __m256i isVisited = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(stamps, epoch));
+        return _mm256_andnot_pd(_mm256_castsi256_pd(isVisited), _mm256_loadu_pd(weights));
+    }
+
+    __attribute__((target("avx2")))
+    static inline double horizontalSum(__m256d values) {
+        __m128d low = _mm256_castpd256_pd128(values);
+        __m128d high = _mm256_extractf128_pd(values, 1);
+        low = _mm_add_pd(low, high);
+        return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+    }
+
+    __attribute__((target("avx2")))
+    static int32_t rouletteSelectAvx2(const double *weights, const uint32_t *visited, uint32_t epoch, int32_t count, double choice) {
+        int32_t blocksEnd = count & ~3;
+        __m128i epochs = _mm_set1_epi32(static_cast<int32_t>(epoch));
+
+        // First pass, total of the masked row
+        __m256d acc = _mm256_setzero_pd();
+        for (int32_t i = 0; i < blocksEnd; i += 4) {
+            acc = _mm256_add_pd(acc, maskedLoad(weights + i, visited + i, epochs));
+        }
+
+        double total = horizontalSum(acc);
+        for (int32_t i = blocksEnd; i < count; ++i) {
+            total += visited[i] == epoch ? 0.0 : weights[i];
+        }
+
+        if (total <= 0.0)
+            return -1;
+
+        // Second pass, skip whole blocks until the one holding the target
+        double target = choice * total;
+        double running = 0.0;
+        int32_t lastBlock = -1;
+        for (int32_t i = 0; i < blocksEnd; i += 4) {
+            double block = horizontalSum(maskedLoad(weights + i, visited + i, epochs));
+            if (block <= 0.0)
+                continue;
+
+            lastBlock = i;
+            if (running + block > target) {
+                for (int32_t j = i; j < i + 4; ++j) {
+                    double weight = visited[j] == epoch ? 0.0 : weights[j];
+                    running += weight;
+                    if (weight > 0.0 && running > target)
+                        return j;
+                }
+            }
+            else {
+                running += block;
+            }
+        }
+
+        int32_t last = -1;
+        if (lastBlock != -1) {
+            for (int32_t j = lastBlock; j < lastBlock + 4; ++j) {
+                if (visited[j] != epoch && weights[j] > 0.0)
+                    last = j;
+            }
+        }
+
+        for (int32_t i = blocksEnd; i < count; ++i) {
+            double weight = visited[i] == epoch ? 0.0 : weights[i];
+            if (weight > 0.0) {
+                running += weight;
+                last = i;
+                if (running > target)
+                    return i;
+            }
+        }
+
+        // Rounding may leave the prefix sum a bit short of the target
+        return last;
+    }
+
+#endif
+
+    using select_fn = int32_t (*)(const double*, const uint32_t*, uint32_t, int32_t, double);
+
+    static select_fn chooseImplementation() {
+#ifdef ACO_SELECTION_AVX2
+        // Runs during static initialization, maybe before libgcc did it
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return rouletteSelectAvx2;
+#endif
+        return rouletteSelectScalar;
+    }
+
+    static const select_fn selectImpl = chooseImplementation();
+
+    int32_t rouletteSelect(const double *weights, const uint32_t *visited, uint32_t epoch, int32_t count, double choice) {
+        return selectImpl(weights, visited, epoch, count, choice);
+    }
+
+    bool simdSelectionEnabled() {
+        return selectImpl != rouletteSelectScalar;
+    }
+
+    int32_t argmaxSelect(const double *weights, const uint32_t *visited, uint32_t epoch, int32_t count) {
+        int32_t best = -1;
+        double bestWeight = 0.0;
+        for (int32_t i = 0; i < count; ++i) {
+            if (visited[i] != epoch && weights[i] > bestWeight) {
+                bestWeight = weights[i];
+                best = i;
+            }
+        }
+        return best;
+    }
+
+}
@@ -0,0 +1,293 @@
+#include <aco/tour.hpp>
+
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+namespace arti::aco {
+
+    array_tour::array_tour()
+      : m_path(nullptr),
+        m_pathSize(0) {
+
+    }
+
+    void array_tour::build(graph_t::node_id *path, int32_t pathSize) {
+        m_path = path;
+        m_pathSize = pathSize;
+
+        m_position.resize(pathSize);
+        for (int32_t it = 0; it < pathSize; ++it) {
+            m_position[path[it]] = it;
+        }
+    }
+
+    bool array_tour::between(graph_t::node_id node_A, graph_t::node_id node_B, graph_t::node_id node_C) const {
+        auto posA = m_position[node_A];
+        auto posB = m_position[node_B];
+        auto posC = m_position[node_C];
+
+        if (posA <= posC)
+            return posA <= posB && posB <= posC;
+        return posB >= posA || posB <= posC;
+    }
+
+    void array_tour::reverse(graph_t::node_id node_A, graph_t::node_id node_B) {
+        int32_t first = m_position[node_A];
+        int32_t last = m_position[node_B];
+
+        // The shorter side of the cycle
+        int32_t length = (last - first + m_pathSize) % m_pathSize + 1;
+        if (2 * length > m_pathSize) {
+            first = last + 1 == m_pathSize ? 0 : last + 1;
+            last = first + m_pathSize - length - 1;
+            length = m_pathSize - length;
+            last = last >= m_pathSize ? last - m_pathSize : last;
+        }
+
+        for (int32_t it = 0; it < length / 2; ++it) {
+            std::swap(m_path[first], m_path[last]);
+            m_position[m_path[first]] = first;
+            m_position[m_path[last]] = last;
+
+            first = first + 1 == m_pathSize ? 0 : first + 1;
+            last = last == 0 ? m_pathSize - 1 : last - 1;
+        }
+    }
+
+    two_level_list::two_level_list()
+      : m_size(0),
+        m_groupSize(0),
+        m_segmentsCount(0),
+        m_unbalanced(false) {
+
+    }
+
+    void two_level_list::build(const graph_t::node_id *path, int32_t pathSize) {
+        m_size = pathSize;
+        m_groupSize = std::max(8, static_cast<int32_t>(std::sqrt(static_cast<double>(pathSize))));
+        m_segmentsCount = (pathSize + m_groupSize - 1) / m_groupSize;
+        m_unbalanced = false;
+
+        m_parent.resize(pathSize);
+        m_id.resize(pathSize);
+        m_succ.resize(pathSize);
+        m_pred.resize(pathSize);
+
+        m_reversed.assign(m_segmentsCount, 0);
+        m_first.resize(m_segmentsCount);
+        m_last.resize(m_segmentsCount);
+        m_segmentSize.resize(m_segmentsCount);
+        m_rank.resize(m_segmentsCount);
+        m_segmentNext.resize(m_segmentsCount);
+        m_segmentPrev.resize(m_segmentsCount);
+
+        for (int32_t segment = 0; segment < m_segmentsCount; ++segment) {
+            auto first = segment * m_groupSize;
+            auto last = std::min(pathSize, first + m_groupSize);
+            m_nodes.assign(path + first, path + last);
+            assign(segment, m_nodes);
+
+            m_rank[segment] = segment;
+            m_segmentNext[segment] = segment + 1 == m_segmentsCount ? 0 : segment + 1;
+            m_segmentPrev[segment] = segment == 0 ? m_segmentsCount - 1 : segment - 1;
+        }
+    }
+
+    void two_level_list::toPath(graph_t::node_id *path) const {
+        if (m_size == 0)
+            return;
+
+        auto node = forwardFirst(0);
+        for (int32_t it = 0; it < m_size; ++it) {
+            path[it] = node;
+            node = next(node);
+        }
+    }
+
+    int64_t two_level_list::key(graph_t::node_id node) const {
+        return (static_cast<int64_t>(m_rank[m_parent[node]]) << 32) | offset(node);
+    }
+
+    bool two_level_list::between(graph_t::node_id node_A, graph_t::node_id node_B, graph_t::node_id node_C) const {
+        auto keyA = key(node_A);
+        auto keyB = key(node_B);
+        auto keyC = key(node_C);
+
+        if (keyA <= keyC)
+            return keyA <= keyB && keyB <= keyC;
+        return keyB >= keyA || keyB <= keyC;
+    }
+
+    void two_level_list::reverse(graph_t::node_id node_A, graph_t::node_id node_B) {
+        // Reversing the whole cycle gives the same cycle
+        if (node_A == node_B || next(node_B) == node_A)
+            return;
+
+        auto segmentA = m_parent[node_A];
+        if (segmentA == m_parent[node_B]) {
+            // Otherwise the path goes around the cycle and the rest of it is inside the segment
+            if (offset(node_A) <= offset(node_B)) {
+                reverseInside(segmentA, node_A, node_B);
+            }
+            else {
+                reverseInside(segmentA, next(node_B), prev(node_A));
+            }
+            return;
+        }
+
+        // Make the path start and end at the ends of some segments
+        splitBefore(node_A);
+        if (m_parent[node_A] != m_parent[node_B]) {
+            splitAfter(node_B, m_parent[node_A]);
+        }
+
+        if (m_parent[node_A] == m_parent[node_B]) {
+            reverse(node_A, node_B);
+        }
+        else {
+            reverseSegments(m_parent[node_A], m_parent[node_B]);
+        }
+
+        if (m_unbalanced) {
+            std::vector<graph_t::node_id> path(m_size);
+            toPath(path.data());
+            build(path.data(), m_size);
+        }
+    }
+
+    void two_level_list::collect(graph_t::node_id node_A, graph_t::node_id node_B, std::vector<graph_t::node_id> &nodes) const {
+        for (auto node = node_A; ; node = next(node)) {
+            nodes.push_back(node);
+            if (node == node_B)
+                break;
+        }
+    }
+
+    void two_level_list::assign(int32_t segment, const std::vector<graph_t::node_id> &nodes) {
+        auto size = static_cast<int32_t>(nodes.size());
+
+        m_reversed[segment] = 0;
+        m_first[segment] = nodes.front();
+        m_last[segment] = nodes.back();
+        m_segmentSize[segment] = size;
+
+        for (int32_t it = 0; it < size; ++it) {
+            auto node = nodes[it];
+            m_parent[node] = segment;
+            m_id[node] = it;
+            m_succ[node] = it + 1 < size ? nodes[it + 1] : -1;
+            m_pred[node] = it > 0 ? nodes[it - 1] : -1;
+        }
+
+        if (size > 4 * m_groupSize)
+            m_unbalanced = true;
+    }
+
+    void two_level_list::reverseInside(int32_t segment, graph_t::node_id node_A, graph_t::node_id node_B) {
+        if (node_A == forwardFirst(segment) && node_B == forwardLast(segment)) {
+            m_reversed[segment] ^= 1;
+            return;
+        }
+
+        m_nodes.clear();
+        collect(forwardFirst(segment), forwardLast(segment), m_nodes);
+        std::reverse(m_nodes.begin() + offset(node_A), m_nodes.begin() + offset(node_B) + 1);
+        assign(segment, m_nodes);
+    }
+
+    void two_level_list::reverseSegments(int32_t first, int32_t last) {
+        // The run or the rest of the segments, whichever is shorter
+        auto count = (m_rank[last] - m_rank[first] + m_segmentsCount) % m_segmentsCount + 1;
+        if (2 * count > m_segmentsCount) {
+            auto restFirst = m_segmentNext[last];
+            last = m_segmentPrev[first];
+            first = restFirst;
+            count = m_segmentsCount - count;
+        }
+
+        m_segments.clear();
+        for (auto segment = first; static_cast<int32_t>(m_segments.size()) < count; segment = m_segmentNext[segment]) {
+            m_segments.push_back(segment);
+        }
+
+        auto before = m_segmentPrev[first];
+        auto after = m_segmentNext[last];
+
+        // The run takes the same ranks in the opposite order
+        auto firstRank = m_rank[first];
+        auto prevSegment = before;
+        for (int32_t it = count - 1; it >= 0; --it) {
+            auto segment = m_segments[it];
+            m_reversed[segment] ^= 1;
+            m_rank[segment] = (firstRank + (count - 1 - it)) % m_segmentsCount;
+
+            m_segmentPrev[segment] = prevSegment;
+            m_segmentNext[prevSegment] = segment;
+            prevSegment = segment;
+        }
+        m_segmentNext[prevSegment] = after;
+        m_segmentPrev[after] = prevSegment;
+    }
+
+    void two_level_list::splitBefore(graph_t::node_id node) {
+        auto segment = m_parent[node];
+        if (node == forwardFirst(segment))
+            return;
+
+        m_nodes.clear();
+        collect(forwardFirst(segment), forwardLast(segment), m_nodes);
+        auto split = offset(node);
+        auto size = static_cast<int32_t>(m_nodes.size());
+
+        if (split <= size - split) {
+            // The nodes before go at the end of the previous segment
+            auto prevSegment = m_segmentPrev[segment];
+            m_moved.clear();
+            collect(forwardFirst(prevSegment), forwardLast(prevSegment), m_moved);
+            m_moved.insert(m_moved.end(), m_nodes.begin(), m_nodes.begin() + split);
+            m_nodes.erase(m_nodes.begin(), m_nodes.begin() + split);
+            assign(prevSegment, m_moved);
+        }
+        else {
+            // The node and the ones after go at the start of the next segment
+            auto nextSegment = m_segmentNext[segment];
+            m_moved.assign(m_nodes.begin() + split, m_nodes.end());
+            collect(forwardFirst(nextSegment), forwardLast(nextSegment), m_moved);
+            m_nodes.resize(split);
+            assign(nextSegment, m_moved);
+        }
+        assign(segment, m_nodes);
+    }
+
+    void two_level_list::splitAfter(graph_t::node_id node, int32_t keep) {
+        auto segment = m_parent[node];
+        if (node == forwardLast(segment))
+            return;
+
+        m_nodes.clear();
+        collect(forwardFirst(segment), forwardLast(segment), m_nodes);
+        auto split = offset(node) + 1;
+        auto size = static_cast<int32_t>(m_nodes.size());
+
+        auto nextSegment = m_segmentNext[segment];
+        if (size - split < split && nextSegment != keep) {
+            // The nodes after go at the start of the next segment
+            m_moved.assign(m_nodes.begin() + split, m_nodes.end());
+            collect(forwardFirst(nextSegment), forwardLast(nextSegment), m_moved);
+            m_nodes.resize(split);
+            assign(nextSegment, m_moved);
+        }
+        else {
+            // The node and the ones before go at the end of the previous segment
+            auto prevSegment = m_segmentPrev[segment];
+            m_moved.clear();
+            collect(forwardFirst(prevSegment), forwardLast(prevSegment), m_moved);
+            m_moved.insert(m_moved.end(), m_nodes.begin(), m_nodes.begin() + split);
+            m_nodes.erase(m_nodes.begin(), m_nodes.begin() + split);
+            assign(prevSegment, m_moved);
+        }
+        assign(segment, m_nodes);
+    }
+
+}
@@ -5,6 +5,8 @@
 
 #include <json.hpp>
 
+#include <instance_io.hpp>
+
 namespace arti {
 
     bool AntVisualization::onInit() {
@@ -36,11 +38,8 @@ namespace arti {
         showAllEdges = true;
         modalOpen = false;
         editMode = false;
-        nAlgoStep = 0;
 
-        maxPheromone = 1.0;
-        bestPathSoFarLength = std::numeric_limits<double>::max();
-        actBestPath = std::numeric_limits<double>::max();
+        solver.reset(params);
 
         updateStaticLayer();
 
@@ -105,7 +104,7 @@ namespace arti {
                         // Add a node
                         if (input.buttonReleased(button_t::Right) && !chosenNode.has_value()) {
                             addNode = false;
-                            auto nodeId = g.addNode(); ph.addNode();
+                            auto nodeId = g.addNode();
                             nodesPos[nodeId] = worldPos;
                             resetAlgo();
                             updateStaticLayer();
@@ -123,7 +122,6 @@ namespace arti {
                                     if (chosenNode.has_value()) {
                                         if (chosenNode.value() != it) {
                                             g.connect(chosenNode.value(), it, 1.0);
-                                            ph.connect(chosenNode.value(), it, 1.0);
                                             updateStaticLayer();
                                             weightsHelper.clear();
                                             weightsHelper = g.getNeighbors(chosenNode.value());
@@ -172,159 +170,11 @@ namespace arti {
             }
             // ALGORITH!!!
             else if (algoStep && g.size() > 0) {
-                std::set<uint64_t> alreadyUpdated;
-
-                ++nAlgoStep;
                 accTime += delta;
                 if (!autoRun) 
                     algoStep = false;
 
-                // Reset the previous state of the ants
-                // And randomly choose the starting node of the new path
-                for (auto &a : ants) {
-                    a.reset();
-                    auto visited = random::i_zero_intMax() % g.size();
-                    a.visitNode(visited);
-                }
-
-                // Iterate until the paths of avery ant is complete
-                for (int itNodes = 1; itNodes < g.size(); ++itNodes) {
-                    // For every ant choose the next node in the path based
-                    // On the probabilities and pheromones trails
-                    int antsMoving = 0;
-                    for (auto& ant : ants) {
-                        if (ant.stuck) continue;
-                        
-                        auto currNode = ant.currNode();
-
-                        std::vector<std::pair<double, graph_t::node_id>> probs;
-                        probs.reserve(ant.graph.size());
-                        double probTotal = 0.0;
-
-                        // Calculate probabilities of choosing a node
-                        for (auto& [neighId, neighWeight] : ant.graph.getNeighbors(currNode)) {
-                            if (! ant.visited[neighId]) {
-                                auto prob = std::pow(ph.getWeigth(currNode, neighId), alpha) * std::pow(1.0 / neighWeight, beta);
-                                probs.push_back({ prob, neighId });
-                                probTotal += probs.back().first;
-                                assert(!std::isnan(prob) && !std::isinf(prob) && std::abs(neighWeight) > math::constants::EPS);
-                            }
-                        }
-
-                        // The ant got stuck!
-                        if (probs.size() == 0 || (std::abs(probTotal) <= math::constants::EPS)) {
-                            ant.stuck = true;
-                            continue;
-                        }
-
-                        ++antsMoving;
-
-                        // Calculate the prefix sum array of probabilities
-                        probs[0].first /= probTotal;
-                        for (size_t i = 1; i < probs.size(); ++i) {
-                            probs[i].first /= probTotal;
-                            probs[i].first += probs[i - 1].first;
-                        }
-
-                        // Choose any random node based on the probabilties
-                        // in the prefix sum array
-                        auto choice = random::f_zero_to_one();
-                        graph_t::node_id chosen = -1;
-
-                        if (choice < probs.front().first) {
-                            chosen = probs.front().second;
-                        }
-                        else {
-                            for (graph_t::node_id itNeighs = 1; itNeighs < probs.size(); ++itNeighs) {
-                                if (choice > probs[itNeighs - 1].first && choice <= probs[itNeighs].first) {
-                                    chosen = probs[itNeighs].second;
-                                    break;
-                                }
-                            }
-                        }
-
-                        if (chosen == -1) {
-                            throw std::runtime_error("How this happened?");
-                        }
-
-                        // The ant visit the node
-                        ant.visitNode(chosen);
-                    }
-
-                    if (antsMoving == 0) {
-                        logger::critical("What?? there are no paths?");
-                        break;
-                    }
-                }
-
-                // Update pheromones
-                graph_t newPh;
-
-                // Create the new pheromone graph
-                for (graph_t::node_id itNode = 0; itNode < ph.size(); ++itNode) {
-                    newPh.addNode();
-                }
-
-                // Set the new pheromones graph to 0 and 
-                // 'vanish' the old pheromone graph
-                alreadyUpdated.clear();
-                for (auto& [itNode, neighbors] : ph) {
-                    for (auto& [neigh, weight] : neighbors) {
-                        auto key = ((uint64_t(std::min(itNode, neigh)) << 32) | uint64_t(std::max(itNode, neigh)));
-                        if (alreadyUpdated.find(key) == alreadyUpdated.end()) {
-                            newPh.connect(itNode, neigh, 0);
-                            ph.connect(itNode, neigh, (1.0 - rho) * weight);
-                        }
-                    }
-                }
-
-                // For every ant update the pheromone graph
-                // Based on the total length of the chosen path
-                aco::ant* chosenPath = &(ants.front());
-                double minPath = ants.front().distanceTraveled();
-
-                for (auto& ant : ants) {
-                    auto pathLength = ant.distanceTraveled();
-                    auto pheromoneUpdate = 1.0 / pathLength;
-                    
-                    // Save the best path
-                    if (pathLength < minPath) {
-                        minPath = pathLength;
-                        chosenPath = &ant;
-                    }
-
-                    newPh.connect(ant.path.front(), ant.path.back(), newPh.getWeigth(ant.path.front(), ant.path.back()) + pheromoneUpdate);
-                    
-                    auto lIt = ant.path.begin();
-                    for (auto it = ++(ant.path.begin()); it != ant.path.end(); ++it) {
-                        newPh.connect(*lIt, *it, newPh.getWeigth(*lIt, *it) + pheromoneUpdate);
-                        lIt = it;
-                    }
-                }
-
-                // If the best path found on this iteration
-                // is better than the already found update it
-                if (minPath < bestPathSoFarLength) {
-                    bestPathSoFarLength = minPath;
-                    bestPathSoFar = chosenPath->path;
-                }
-
-                actBestPath = minPath;
-
-                maxPheromone = std::numeric_limits<double>::min();
-
-                // Update the pheromone graph, sum the 'old' updated pheromones
-                // And the new calculated pheromones
-                alreadyUpdated.clear();
-                for (auto& [itNode, neighbors] : ph) {
-                    for (auto& [neigh, weight] : neighbors) {
-                        auto key = ((uint64_t(std::min(itNode, neigh)) << 32) | uint64_t(std::max(itNode, neigh)));
-                        if (alreadyUpdated.find(key) == alreadyUpdated.end()) {
-                            ph.connect(itNode, neigh, weight + newPh.getWeigth(itNode, neigh));
-                            maxPheromone = std::max(maxPheromone, weight);
-                        }
-                    }
-                }
+                solver.step();
 
                 // Re-render the graph
                 updateStaticLayer();
@@ -364,9 +214,12 @@ namespace arti {
         // Enable edition mode
         if (ImGui::Checkbox("Edition mode", &editMode)) {
             autoRun = false;
-            updateStaticLayer();
-            if (!editMode)
+            // The solver has to see the edited graph
+            if (!editMode) {
                 chosenNode = {};
+                resetAlgo();
+            }
+            updateStaticLayer();
         }
 
         ImGui::Separator();
@@ -390,7 +243,6 @@ namespace arti {
                     std::string t = fmt::format("D {}", neigh);
                     if (ImGui::Button(t.c_str(), {16, 20})) {
                         g.disconnect(chosenNode.value(), neigh);
-                        ph.disconnect(chosenNode.value(), neigh);
                         update = true;
                         break;
                     }
@@ -432,44 +284,177 @@ namespace arti {
             ImGui::Spacing();
 
             // Algorithm info
-            ImGui::Text("Algorithm step: %d", nAlgoStep);
-            if (bestPathSoFarLength == graph_t::inf) {
+            ImGui::Text("Algorithm step: %d", solver.iterations());
+            ImGui::Text("Graph storage: %s", solver.isDense() ? "matrix" : "CSR");
+            ImGui::Text("Seed: %llu", static_cast<unsigned long long>(solver.seed()));
+            if (solver.bestLength() == graph_t::inf) {
                 ImGui::Text("MinPathLength: inf");
             }
             else {
-                ImGui::Text("MinPathLength: %.3f", bestPathSoFarLength);
+                ImGui::Text("MinPathLength: %.3f", solver.bestLength());
             }
 
-            if (actBestPath == graph_t::inf) {
+            if (solver.iterationBestLength() == graph_t::inf) {
                 ImGui::Text("ActMinPathLength: inf");
             }
             else {
-                ImGui::Text("ActMinPathLength: %.3f", actBestPath);
+                ImGui::Text("ActMinPathLength: %.3f", solver.iterationBestLength());
+            }
+            if (params.rule == aco::update_rule::max_min) {
+                ImGui::Text("Trail bounds: [%.3g, %.3g]", solver.tauMin(), solver.tauMax());
+                ImGui::Text("Restarts: %d", solver.restarts());
+            }
+            if (params.pruneAnts) {
+                ImGui::Text("Abandoned ants: %lld", static_cast<long long>(solver.abandonedAnts()));
             }
             ImGui::Text("Time running: %.3f", accTime);
 
             ImGui::Separator();
             ImGui::Spacing();
 
-            if (ImGui::InputInt("Nº Ants", &nAnts)) {
+            if (ImGui::InputInt("Nº Ants", &params.nAnts)) {
+                params.nAnts = std::max(params.nAnts, 1);
                 resetAlgo();
                 updateStaticLayer();
             }
 
+            // 0 uses every hardware thread
+            if (ImGui::InputInt("Threads", &params.nThreads)) {
+                params.nThreads = std::max(params.nThreads, 0);
+                solver.setParams(params);
+            }
+
+            // Same seed, same paths, 0 takes a new one on every reset
+            if (ImGui::InputScalar("Seed", ImGuiDataType_U64, &params.seed)) {
+                resetAlgo();
+                updateStaticLayer();
+            }
+
+            // Nearest neighbors tried first, 0 tries all of them
+            if (ImGui::InputInt("Candidates", &params.nCandidates)) {
+                params.nCandidates = std::max(params.nCandidates, 0);
+                solver.setParams(params);
+            }
+
+            // Ants that can't beat the best path stop building it
+            if (ImGui::Checkbox("Prune hopeless ants", &params.pruneAnts)) {
+                solver.setParams(params);
+            }
+
             ImGui::Separator();
             ImGui::Spacing();
 
             // Algorithm variables and stuff
-            if (ImGui::InputDouble("alpha", &alpha)) {
+            if (ImGui::InputDouble("alpha", &params.alpha)) {
+                solver.setParams(params);
                 updateStaticLayer();
             }
-            if (ImGui::InputDouble("beta", &beta)) {
+            if (ImGui::InputDouble("beta", &params.beta)) {
+                solver.setParams(params);
                 updateStaticLayer();
             }
-            if (ImGui::InputDouble("rho", &rho)) {
+            if (ImGui::InputDouble("rho", &params.rho)) {
+                solver.setParams(params);
                 updateStaticLayer();
             }
 
+            const char* rules[] = { "Ant System", "MAX-MIN", "Ant Colony System", "Elitist", "Rank-based", "Population" };
+            int rule = static_cast<int>(params.rule);
+            if (ImGui::Combo("Update rule", &rule, rules, IM_ARRAYSIZE(rules))) {
+                params.rule = static_cast<aco::update_rule>(rule);
+                solver.setParams(params);
+            }
+
+            if (params.rule == aco::update_rule::max_min) {
+                if (ImGui::InputDouble("pBest", &params.pBest)) {
+                    params.pBest = std::clamp(params.pBest, 1e-6, 1.0 - 1e-6);
+                    solver.setParams(params);
+                }
+                if (ImGui::InputInt("Global best every", &params.globalBestPeriod)) {
+                    params.globalBestPeriod = std::max(params.globalBestPeriod, 0);
+                    solver.setParams(params);
+                }
+                if (ImGui::InputInt("Restart after", &params.stagnationLimit)) {
+                    params.stagnationLimit = std::max(params.stagnationLimit, 0);
+                    solver.setParams(params);
+                }
+            }
+            else if (params.rule == aco::update_rule::colony_system) {
+                if (ImGui::InputDouble("q0", &params.q0)) {
+                    params.q0 = std::clamp(params.q0, 0.0, 1.0);
+                    solver.setParams(params);
+                }
+                if (ImGui::InputDouble("xi", &params.xi)) {
+                    params.xi = std::clamp(params.xi, 0.0, 1.0);
+                    solver.setParams(params);
+                }
+            }
+            else if (params.rule == aco::update_rule::elitist) {
+                if (ImGui::InputDouble("Elitist weight", &params.elitistWeight)) {
+                    params.elitistWeight = std::max(params.elitistWeight, 0.0);
+                    solver.setParams(params);
+                }
+            }
+            else if (params.rule == aco::update_rule::rank_based) {
+                if (ImGui::InputInt("Ranked ants", &params.rankedAnts)) {
+                    params.rankedAnts = std::max(params.rankedAnts, 1);
+                    solver.setParams(params);
+                }
+            }
+            else if (params.rule == aco::update_rule::population) {
+                if (ImGui::InputInt("Population size", &params.populationSize)) {
+                    params.populationSize = std::max(params.populationSize, 1);
+                    solver.setParams(params);
+                }
+            }
+
+            const char* constructions[] = { "Independent ants", "Beam", "Backtracking" };
+            int construction = static_cast<int>(params.construction);
+            if (ImGui::Combo("Construction", &construction, constructions, IM_ARRAYSIZE(constructions))) {
+                params.construction = static_cast<aco::construction_mode>(construction);
+                solver.setParams(params);
+            }
+
+            // The width of the beam is the number of ants
+            if (params.construction == aco::construction_mode::beam) {
+                if (ImGui::InputInt("Beam extensions", &params.beamExtensions)) {
+                    params.beamExtensions = std::max(params.beamExtensions, 1);
+                    solver.setParams(params);
+                }
+            }
+            else if (params.construction == aco::construction_mode::backtracking) {
+                if (ImGui::InputInt("Backtrack limit", &params.backtrackLimit)) {
+                    params.backtrackLimit = std::max(params.backtrackLimit, 0);
+                    solver.setParams(params);
+                }
+            }
+
+            ImGui::Separator();
+            ImGui::Spacing();
+
+            const char* localSearches[] = { "None", "2-opt", "Or-opt", "Restricted 3-opt" };
+            int localSearch = static_cast<int>(params.localSearch);
+            if (ImGui::Combo("Local search", &localSearch, localSearches, IM_ARRAYSIZE(localSearches))) {
+                params.localSearch = static_cast<aco::local_search>(localSearch);
+                solver.setParams(params);
+            }
+
+            if (params.localSearch != aco::local_search::none) {
+                if (ImGui::Checkbox("Only the iteration best", &params.localSearchBestOnly)) {
+                    solver.setParams(params);
+                }
+                if (ImGui::InputInt("Neighbors", &params.localSearchNeighbors)) {
+                    params.localSearchNeighbors = std::max(params.localSearchNeighbors, 1);
+                    solver.setParams(params);
+                }
+
+                // Nodes from which the moves work on a two-level list, 0 never
+                if (ImGui::InputInt("Two-level list from", &params.localSearchListNodes)) {
+                    params.localSearchListNodes = std::max(params.localSearchListNodes, 0);
+                    solver.setParams(params);
+                }
+            }
+
             ImGui::Separator();
             ImGui::Spacing();
         }
@@ -512,23 +497,20 @@ namespace arti {
                 ImGui::CloseCurrentPopup();
                 modalOpen = false;
                 g.reset();
-                ph.reset();
                 nodesPos.clear();
-                resetAlgo();
 
                 for (int i = 0; i < numberOfNodes; ++i) {
                     auto nodeId = g.addNode();
-                    ph.addNode();
                     nodesPos[nodeId] = math::vec2df{
                         10.0f + static_cast<float>(random::i_zero_intMax() % 620),
                         10.0f + static_cast<float>(random::i_zero_intMax() % 620)
                     };
                     for (graph_t::node_id it = 0; it < nodeId; ++it) {
                         g.connect(nodeId, it, (nodesPos[nodeId] - nodesPos[it]).length());
-                        ph.connect(nodeId, it, 1.0);
                     }
                 }
 
+                resetAlgo();
                 updateStaticLayer();
             }
             ImGui::SetItemDefaultFocus();
@@ -563,21 +545,18 @@ namespace arti {
 
                 for (graph_t::node_id it = 0; it < g.size(); ++it) {
                     for (graph_t::node_id jt = 0; jt < g.size(); ++jt) {
-                        graphMatrix[it][jt] = ph.getWeigth(it, jt);
+                        graphMatrix[it][jt] = solver.pheromone(it, jt);
                     }
                 }
 
                 saveData["pheromonesMatrix"] = graphMatrix;
 
-                saveData["bestPathSoFarLength"] = bestPathSoFarLength;
+                saveData["bestPathSoFarLength"] = solver.bestLength();
 
-                saveData["bestPathSoFar"] = bestPathSoFar;
-                saveData["number_iterations"] = nAlgoStep;
+                saveData["bestPathSoFar"] = solver.best();
+                saveData["number_iterations"] = solver.iterations();
                 
-                saveData["algorithmParameters"]["alpha"] = alpha;
-                saveData["algorithmParameters"]["beta"] = beta;
-                saveData["algorithmParameters"]["rho"] = rho;
-                saveData["algorithmParameters"]["nAnts"] = ants.size();
+                saveData["algorithmParameters"] = io::writeParams(params, solver.seed());
 
                 std::ofstream saveFile(filename);
 
@@ -612,104 +591,37 @@ namespace arti {
             ImGui::EndGroup();
             
             if (ImGui::Button("OK", ImVec2(120, 0))) {
-                if (radioGroup == 1) {
-                    std::ifstream fileInput(filename);
-                    if (fileInput.is_open()) {
-                        nlohmann::json inputData;
-                        fileInput >> inputData;
-
-                        g.reset();
-                        ph.reset();
-
-                        for (graph_t::node_id it = 0; it < inputData["graph"].size(); ++it) {
-                            g.addNode();
-                            ph.addNode();
-                        }
+                bool loaded = false;
+                std::map<graph_t::node_id, math::vec2df> coords;
 
-                        auto numOfNodesPerRow = static_cast<int>(std::ceil(std::sqrt(inputData["graph"].size())));
-
-                        for (graph_t::node_id it = 0; it < inputData["graph"].size(); ++it) {
-                            if (inputData.contains("nodesCoords")) {
-                                nodesPos[it] = { 
-                                    inputData["nodesCoords"][it]["x"],
-                                    inputData["nodesCoords"][it]["y"]
-                                };
-                            }
-                            else {
-                                nodesPos[it] = math::vec2df{
-                                    30.0f + static_cast<float>(static_cast<float>(it % numOfNodesPerRow) * (600.0 / numOfNodesPerRow)),
-                                    30.0f + static_cast<float>(static_cast<float>(it / numOfNodesPerRow) * (600.0 / numOfNodesPerRow))
-                                };
-                            }
-                            for (graph_t::node_id jt = 0; jt < inputData["graph"][it].size(); ++jt) {
-                                if (it == jt)
-                                    continue;
-                                g.connect(it, jt, inputData["graph"][it][jt]);
-                                ph.connect(it, jt, 1.0);
-                            }
-                        }
-
-                        if (inputData.contains("algorithmParameters")) {
-                            if (inputData.contains("nAnts"))
-                                nAnts = inputData["algorithmParameters"]["nAnts"];
-                            if (inputData.contains("alpha"))
-                                alpha = inputData["algorithmParameters"]["alpha"];
-                            if (inputData.contains("beta"))
-                                beta = inputData["algorithmParameters"]["beta"];
-                            if (inputData.contains("rho"))
-                                rho = inputData["algorithmParameters"]["rho"];
-                        }
-
-                        resetAlgo();
-                        updateStaticLayer();
-                    }
-                    else {
-                        logger::error("Couldn't open the file");
-                    }
+                if (radioGroup == 1) {
+                    loaded = io::loadJson(filename, g, params, &coords);
                 }
                 else if (radioGroup == 2) {
-                    std::ifstream fileInput(filename);
-                    if (fileInput.is_open()) {
-                        int gSize;
-                        double weight;
-
-                        fileInput >> gSize;
-
-                        g.reset();
-                        ph.reset();
-                        nodesPos.clear();
-                        weightsHelper.clear();
+                    loaded = io::loadWeightsMatrix(filename, g);
+                }
+                else {
+                    logger::error("What??");
+                }
 
-                        for (int i = 0; i < gSize; ++i) {
-                            g.addNode();
-                            ph.addNode();
-                        }
+                if (loaded) {
+                    nodesPos = std::move(coords);
+                    weightsHelper.clear();
 
-                        auto numOfNodesPerRow = static_cast<int>(std::ceil(std::sqrt(gSize)));
-
-                        for (int i = 0; i < gSize; ++i) {
-                            nodesPos[i] = math::vec2df{
-                                30.0f + static_cast<float>(static_cast<float>(i % numOfNodesPerRow) * (600.0 / numOfNodesPerRow)),
-                                30.0f + static_cast<float>(static_cast<float>(i / numOfNodesPerRow) * (600.0 / numOfNodesPerRow))
-                            };
-                            for (int j = 0; j < gSize; ++j) {
-                                fileInput >> weight;
-                                if (i == j)
-                                    continue;
-                                g.connect(i, j, weight);
-                                ph.connect(i, j, 1.0);
-                            }
-                        }                    
+                    // Nodes without coordinates in the file are laid out in a grid
+                    auto numOfNodesPerRow = static_cast<int>(std::ceil(std::sqrt(g.size())));
 
-                        resetAlgo();
-                        updateStaticLayer();
-                    }
-                    else {
-                        logger::error("Couldn't open the file");
+                    for (graph_t::node_id it = 0; it < g.size(); ++it) {
+                        if (nodesPos.count(it))
+                            continue;
+                        nodesPos[it] = math::vec2df{
+                            30.0f + static_cast<float>(static_cast<float>(it % numOfNodesPerRow) * (600.0 / numOfNodesPerRow)),
+                            30.0f + static_cast<float>(static_cast<float>(it / numOfNodesPerRow) * (600.0 / numOfNodesPerRow))
+                        };
                     }
-                }
-                else {
-                    logger::error("What??");
+
+                    resetAlgo();
+                    updateStaticLayer();
                 }
                 
                 ImGui::CloseCurrentPopup();
@@ -730,7 +642,6 @@ namespace arti {
         // Maybe i should ask for confirmation before?
         if (ImGui::Button("Reset Graph")) {
             g.reset();
-            ph.reset();
             nodesPos.clear();
             renderer.targetDefaultLayer();
             renderer.clear(color::OffBlack);
@@ -764,6 +675,7 @@ namespace arti {
     void AntVisualization::updateStaticLayer() {
         renderer.targetDefaultLayer();
         renderer.clear(color::OffBlack);
+        auto& bestPathSoFar = solver.best();
         if (bestPathSoFar.size() > 1) {
             auto lIt = bestPathSoFar.back();
             for (auto& e : bestPathSoFar) {
@@ -774,15 +686,15 @@ namespace arti {
 
         if (showAllEdges) {
             std::set<uint64_t> alreadyDrawed;
-            for (auto& [it, neighbors] : ph) {
+            for (auto& [it, neighbors] : g) {
                 auto& nodePos = nodesPos[it];
-                for (auto& [neigh, weight] : neighbors) {
+                for (auto& [neigh, _] : neighbors) {
                     auto key = ((uint64_t(std::min(it, neigh)) << 32) | uint64_t(std::max(it, neigh)));
                     if (alreadyDrawed.find(key) == alreadyDrawed.end()) {
                         auto edgeColor = color::OffWhite;
                         if (editMode)
                             edgeColor.a = 255;
-                        else edgeColor.a = ((weight / (maxPheromone)) * 255.0);
+                        else edgeColor.a = ((solver.pheromone(it, neigh) / solver.maxPheromone()) * 255.0);
                         renderer.drawLine(nodePos, nodesPos[neigh], edgeColor);
                         alreadyDrawed.insert(key);
                     }
@@ -790,7 +702,7 @@ namespace arti {
             }
         }
 
-        for (auto& [it, _] : ph) {
+        for (auto& [it, _] : g) {
             auto &nodePos = nodesPos[it];
             renderer.fillCircle(nodePos, node_size, color::White);
             renderer.drawString(nodePos - math::vec2df{static_cast<float>(node_size) * 0.5f, static_cast<float>(node_size) * 2.0f}, fmt::to_string(it), color::CornflowerBlue);
@@ -800,28 +712,8 @@ namespace arti {
 
     void AntVisualization::resetAlgo() {
         // RESET EVERYTHING!
-        nAlgoStep = 0;
-        maxPheromone = 1.0;
-        bestPathSoFar.clear();
-        bestPathSoFarLength = std::numeric_limits<double>::max();
-        actBestPath = std::numeric_limits<double>::max();
         accTime = 0.0f;
-        std::set<uint64_t> alreadyUpdated;
-
-        for (auto& [it, neighbors] : g) {
-            for (auto& [neigh, weight] : neighbors) {
-                auto key = ((uint64_t(std::min(it, neigh)) << 32) | uint64_t(std::max(it, neigh)));
-                if (alreadyUpdated.find(key) == alreadyUpdated.end()) {
-                    ph.connect(it, neigh, 1.0);
-                }
-            }
-        }
-        
-        ants.clear();
-        for (size_t i = 0; i < nAnts; ++i) {
-            ants.emplace_back(g);
-        }
-        nAnts = ants.size();
+        solver.reset(params);
     }
 
 }
\ No newline at end of file
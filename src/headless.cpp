@@ -0,0 +1,280 @@
+#include <headless.hpp>
+
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string_view>
+
+#include <fmt/format.h>
+#include <json.hpp>
+
+#include <logger.hpp>
+#include <instance_io.hpp>
+
+namespace arti::headless {
+
+    using aco::graph_t;
+
+    static constexpr const char *usage =
+        "Usage: {} --headless (--json FILE | --matrix FILE) [options]\n"
+        "\n"
+        "Instance\n"
+        "  --json FILE          file written by \"Save data\", its parameters are the defaults\n"
+        "  --matrix FILE        number of nodes followed by the weights matrix\n"
+        "\n"
+        "Budget, the run stops at the first one reached (100 iterations\n"
+        "if neither --iterations nor --time is given)\n"
+        "  --iterations N       iterations of the colony\n"
+        "  --time SECONDS       wall time\n"
+        "  --target LENGTH      stops once the best path is at most this long\n"
+        "\n"
+        "Parameters\n"
+        "  --alpha X  --beta X  --rho X  --ants N  --threads N  --seed N\n"
+        "  --candidates N       size of the candidate lists, 0 disables them\n"
+        "  --rule NAME          ant_system, max_min, colony_system, elitist, rank_based or population\n"
+        "  --beam N             Beam-ACO construction sampling N next nodes per partial path,\n"
+        "                       the width of the beam is the number of ants\n"
+        "  --backtrack N        the ants step back from dead ends, at most N times per path\n"
+        "  --prune              abandons the ants that can't beat the best path anymore\n"
+        "  --local-search NAME  none, two_opt, or_opt or three_opt\n"
+        "\n"
+        "Output\n"
+        "  --output FILE        writes the results as json, - writes them to stdout\n"
+        "  --report N           prints the best length every N iterations\n";
+
+    struct options {
+        std::string jsonFile;
+        std::string matrixFile;
+        std::string outputFile;
+
+        std::optional<int> iterations;
+        std::optional<double> seconds;
+        std::optional<double> target;
+        int report = 0;
+    };
+
+    template<typename number_type>
+    static bool parseNumber(std::string_view text, number_type &value) {
+        std::string copy(text);
+        char *end = nullptr;
+
+        if constexpr (std::is_floating_point_v<number_type>)
+            value = static_cast<number_type>(std::strtod(copy.c_str(), &end));
+        else if constexpr (std::is_unsigned_v<number_type>)
+            value = static_cast<number_type>(std::strtoull(copy.c_str(), &end, 10));
+        else
+            value = static_cast<number_type>(std::strtoll(copy.c_str(), &end, 10));
+
+        return ! copy.empty() && *end == '\0';
+    }
+
+    bool requested(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            if (std::string_view(argv[i]) == "--headless")
+                return true;
+        }
+        return false;
+    }
+
+    // The instance flags go first so its parameters can be overridden by the rest
+    static bool parseInstance(int argc, char** argv, options &opts) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view flag = argv[i];
+            if (flag != "--json" && flag != "--matrix")
+                continue;
+
+            if (i + 1 >= argc) {
+                logger::error("Missing the file of {}", flag);
+                return false;
+            }
+            (flag == "--json" ? opts.jsonFile : opts.matrixFile) = argv[++i];
+        }
+
+        if (opts.jsonFile.empty() == opts.matrixFile.empty()) {
+            logger::error("Give exactly one of --json or --matrix");
+            return false;
+        }
+        return true;
+    }
+
+    static bool parseOptions(int argc, char** argv, options &opts, aco::colony_params &params) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view flag = argv[i];
+
+            if (flag == "--headless")
+                continue;
+
+            if (flag == "--prune") {
+                params.pruneAnts = true;
+                continue;
+            }
+
+            if (i + 1 >= argc) {
+                logger::error("Unknown option or missing value: {}", flag);
+                return false;
+            }
+            std::string_view value = argv[++i];
+
+            bool valid = true;
+            if (flag == "--json" || flag == "--matrix")
+                continue;
+            else if (flag == "--output")
+                opts.outputFile = value;
+            else if (flag == "--iterations")
+                valid = parseNumber(value, opts.iterations.emplace()) && *opts.iterations >= 0;
+            else if (flag == "--time")
+                valid = parseNumber(value, opts.seconds.emplace()) && *opts.seconds >= 0.0;
+            else if (flag == "--target")
+                valid = parseNumber(value, opts.target.emplace());
+            else if (flag == "--report")
+                valid = parseNumber(value, opts.report) && opts.report >= 0;
+            else if (flag == "--alpha")
+                valid = parseNumber(value, params.alpha);
+            else if (flag == "--beta")
+                valid = parseNumber(value, params.beta);
+            else if (flag == "--rho")
+                valid = parseNumber(value, params.rho) && params.rho >= 0.0 && params.rho <= 1.0;
+            else if (flag == "--ants")
+                valid = parseNumber(value, params.nAnts) && params.nAnts > 0;
+            else if (flag == "--threads")
+                valid = parseNumber(value, params.nThreads) && params.nThreads >= 0;
+            else if (flag == "--seed")
+                valid = parseNumber(value, params.seed);
+            else if (flag == "--candidates")
+                valid = parseNumber(value, params.nCandidates) && params.nCandidates >= 0;
+            else if (flag == "--beam") {
+                valid = parseNumber(value, params.beamExtensions) && params.beamExtensions > 0;
+                params.construction = aco::construction_mode::beam;
+            }
+            else if (flag == "--backtrack") {
+                valid = parseNumber(value, params.backtrackLimit) && params.backtrackLimit >= 0;
+                params.construction = aco::construction_mode::backtracking;
+            }
+            else if (flag == "--local-search") {
+                auto kind = aco::localSearchFromName(value);
+                valid = kind.has_value();
+                if (valid)
+                    params.localSearch = *kind;
+            }
+            else if (flag == "--rule") {
+                auto rule = aco::updateRuleFromName(value);
+                valid = rule.has_value();
+                if (valid)
+                    params.rule = *rule;
+            }
+            else {
+                logger::error("Unknown option: {}", flag);
+                return false;
+            }
+
+            if (! valid) {
+                logger::error("Invalid value for {}: {}", flag, value);
+                return false;
+            }
+        }
+
+        // The target alone might never be reached
+        if (! opts.iterations && ! opts.seconds)
+            opts.iterations = 100;
+
+        return true;
+    }
+
+    int run(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view flag = argv[i];
+            if (flag == "--help" || flag == "-h") {
+                fmt::print(usage, argv[0]);
+                return 0;
+            }
+        }
+
+        options opts;
+        aco::colony_params params;
+        graph_t g;
+
+        if (! parseInstance(argc, argv, opts))
+            return 1;
+
+        bool loaded = opts.jsonFile.empty()
+            ? io::loadWeightsMatrix(opts.matrixFile, g)
+            : io::loadJson(opts.jsonFile, g, params);
+
+        if (! loaded || ! parseOptions(argc, argv, opts, params))
+            return 1;
+
+        if (g.size() < 2) {
+            logger::error("The graph needs at least 2 nodes");
+            return 1;
+        }
+
+        aco::colony_solver solver(g, params);
+
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+        auto elapsed = [&]() {
+            return std::chrono::duration<double>(clock::now() - start).count();
+        };
+
+        // Every budget is checked between iterations
+        std::string stopReason;
+        while (true) {
+            if (opts.iterations && solver.iterations() >= *opts.iterations)
+                stopReason = "iterations";
+            else if (opts.seconds && elapsed() >= *opts.seconds)
+                stopReason = "time";
+            else if (opts.target && solver.bestLength() <= *opts.target)
+                stopReason = "target";
+
+            if (! stopReason.empty())
+                break;
+
+            solver.step();
+
+            if (opts.report > 0 && solver.iterations() % opts.report == 0)
+                fmt::print(stderr, "iteration {} best {} time {:.3f}s\n", solver.iterations(), solver.bestLength(), elapsed());
+        }
+
+        double seconds = elapsed();
+        bool found = solver.bestLength() != graph_t::inf;
+
+        if (opts.outputFile.empty()) {
+            fmt::print("nodes {} iterations {} time {:.3f}s stop {} abandoned {}\n", g.size(), solver.iterations(), seconds, stopReason, solver.abandonedAnts());
+            if (found) {
+                fmt::print("best {}\n", solver.bestLength());
+                fmt::print("path {}\n", fmt::join(solver.best(), " "));
+            }
+            else {
+                fmt::print("no path found\n");
+            }
+            return 0;
+        }
+
+        // Named like the keys of "Save data", without the matrices
+        nlohmann::json results;
+        results["bestPathSoFar"] = solver.best();
+        results["bestPathSoFarLength"] = solver.bestLength();
+        results["number_iterations"] = solver.iterations();
+        results["elapsedSeconds"] = seconds;
+        results["stopReason"] = stopReason;
+        results["abandonedAnts"] = solver.abandonedAnts();
+        results["algorithmParameters"] = io::writeParams(solver.params(), solver.seed());
+
+        if (opts.outputFile == "-") {
+            fmt::print("{}\n", results.dump());
+            return 0;
+        }
+
+        std::ofstream outputFile(opts.outputFile);
+        if (! outputFile.is_open()) {
+            logger::error("Couldn't save the results");
+            return 1;
+        }
+        outputFile << results.dump() << std::endl;
+
+        return 0;
+    }
+
+}
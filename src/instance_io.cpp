@@ -0,0 +1,184 @@
+#include <instance_io.hpp>
+
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#include <logger.hpp>
+
+namespace arti::io {
+
+    void readParams(const nlohmann::json &algoParams, aco::colony_params &params) {
+        if (algoParams.contains("nAnts"))
+            params.nAnts = algoParams["nAnts"];
+        if (algoParams.contains("alpha"))
+            params.alpha = algoParams["alpha"];
+        if (algoParams.contains("beta"))
+            params.beta = algoParams["beta"];
+        if (algoParams.contains("rho"))
+            params.rho = algoParams["rho"];
+        if (algoParams.contains("seed"))
+            params.seed = algoParams["seed"];
+        if (algoParams.contains("updateRule")) {
+            auto rule = aco::updateRuleFromName(algoParams["updateRule"].get<std::string>());
+            if (rule)
+                params.rule = *rule;
+            else
+                logger::error("Unknown update rule, keeping the current one");
+        }
+        if (algoParams.contains("pBest"))
+            params.pBest = algoParams["pBest"];
+        if (algoParams.contains("globalBestPeriod"))
+            params.globalBestPeriod = algoParams["globalBestPeriod"];
+        if (algoParams.contains("stagnationLimit"))
+            params.stagnationLimit = algoParams["stagnationLimit"];
+        if (algoParams.contains("q0"))
+            params.q0 = algoParams["q0"];
+        if (algoParams.contains("xi"))
+            params.xi = algoParams["xi"];
+        if (algoParams.contains("elitistWeight"))
+            params.elitistWeight = algoParams["elitistWeight"];
+        if (algoParams.contains("rankedAnts"))
+            params.rankedAnts = algoParams["rankedAnts"];
+        if (algoParams.contains("populationSize"))
+            params.populationSize = algoParams["populationSize"];
+        if (algoParams.contains("construction")) {
+            auto mode = aco::constructionModeFromName(algoParams["construction"].get<std::string>());
+            if (mode)
+                params.construction = *mode;
+            else
+                logger::error("Unknown construction, keeping the current one");
+        }
+        if (algoParams.contains("beamExtensions"))
+            params.beamExtensions = algoParams["beamExtensions"];
+        if (algoParams.contains("backtrackLimit"))
+            params.backtrackLimit = algoParams["backtrackLimit"];
+        if (algoParams.contains("pruneAnts"))
+            params.pruneAnts = algoParams["pruneAnts"];
+        if (algoParams.contains("localSearch")) {
+            auto kind = aco::localSearchFromName(algoParams["localSearch"].get<std::string>());
+            if (kind)
+                params.localSearch = *kind;
+            else
+                logger::error("Unknown local search, keeping the current one");
+        }
+        if (algoParams.contains("localSearchBestOnly"))
+            params.localSearchBestOnly = algoParams["localSearchBestOnly"];
+        if (algoParams.contains("localSearchNeighbors"))
+            params.localSearchNeighbors = algoParams["localSearchNeighbors"];
+        if (algoParams.contains("localSearchListNodes"))
+            params.localSearchListNodes = algoParams["localSearchListNodes"];
+    }
+
+    nlohmann::json writeParams(const aco::colony_params &params, uint64_t seed) {
+        nlohmann::json algoParams;
+
+        algoParams["alpha"] = params.alpha;
+        algoParams["beta"] = params.beta;
+        algoParams["rho"] = params.rho;
+        algoParams["nAnts"] = params.nAnts;
+        algoParams["seed"] = seed;
+        algoParams["updateRule"] = aco::updateRuleName(params.rule);
+        algoParams["pBest"] = params.pBest;
+        algoParams["globalBestPeriod"] = params.globalBestPeriod;
+        algoParams["stagnationLimit"] = params.stagnationLimit;
+        algoParams["q0"] = params.q0;
+        algoParams["xi"] = params.xi;
+        algoParams["elitistWeight"] = params.elitistWeight;
+        algoParams["rankedAnts"] = params.rankedAnts;
+        algoParams["populationSize"] = params.populationSize;
+        algoParams["construction"] = aco::constructionModeName(params.construction);
+        algoParams["beamExtensions"] = params.beamExtensions;
+        algoParams["backtrackLimit"] = params.backtrackLimit;
+        algoParams["pruneAnts"] = params.pruneAnts;
+        algoParams["localSearch"] = aco::localSearchName(params.localSearch);
+        algoParams["localSearchBestOnly"] = params.localSearchBestOnly;
+        algoParams["localSearchNeighbors"] = params.localSearchNeighbors;
+        algoParams["localSearchListNodes"] = params.localSearchListNodes;
+
+        return algoParams;
+    }
+
+    bool loadJson(const std::string &filename, graph_t &g, aco::colony_params &params, std::map<graph_t::node_id, math::vec2df> *coords) {
+        std::ifstream fileInput(filename);
+        if (! fileInput.is_open()) {
+            logger::error("Couldn't open the file");
+            return false;
+        }
+
+        // Without exceptions, a broken file is just discarded
+        auto inputData = nlohmann::json::parse(fileInput, nullptr, false);
+        if (inputData.is_discarded() || ! inputData.contains("graph") || ! inputData["graph"].is_array()) {
+            logger::error("The file isn't a saved graph");
+            return false;
+        }
+
+        const auto &graph = inputData["graph"];
+
+        g.reset();
+
+        for (graph_t::node_id it = 0; it < graph.size(); ++it) {
+            g.addNode();
+        }
+
+        for (graph_t::node_id it = 0; it < graph.size(); ++it) {
+            if (coords && inputData.contains("nodesCoords") && it < inputData["nodesCoords"].size()) {
+                (*coords)[it] = {
+                    inputData["nodesCoords"][it]["x"],
+                    inputData["nodesCoords"][it]["y"]
+                };
+            }
+            for (graph_t::node_id jt = 0; jt < graph[it].size(); ++jt) {
+                double weight = graph[it][jt];
+                if (it == jt || weight == graph_t::inf)
+                    continue;
+                g.connect(it, jt, weight);
+            }
+        }
+
+        if (inputData.contains("algorithmParameters")) {
+            readParams(inputData["algorithmParameters"], params);
+        }
+
+        return true;
+    }
+
+    bool loadWeightsMatrix(const std::string &filename, graph_t &g) {
+        std::ifstream fileInput(filename);
+        if (! fileInput.is_open()) {
+            logger::error("Couldn't open the file");
+            return false;
+        }
+
+        int gSize = 0;
+        fileInput >> gSize;
+
+        // Read the whole matrix first so a broken file leaves the graph as it was
+        std::vector<double> weights(static_cast<std::size_t>(std::max(gSize, 0)) * std::max(gSize, 0));
+        for (auto &weight : weights) {
+            fileInput >> weight;
+        }
+
+        if (! fileInput || gSize <= 0) {
+            logger::error("The weights matrix is incomplete");
+            return false;
+        }
+
+        g.reset();
+
+        for (int i = 0; i < gSize; ++i) {
+            g.addNode();
+        }
+
+        for (int i = 0; i < gSize; ++i) {
+            for (int j = 0; j < gSize; ++j) {
+                if (i == j)
+                    continue;
+                g.connect(i, j, weights[static_cast<std::size_t>(i) * gSize + j]);
+            }
+        }
+
+        return true;
+    }
+
+}
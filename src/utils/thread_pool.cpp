@@ -0,0 +1,107 @@
+#include <utils/thread_pool.hpp>
+
+#include <algorithm>
+
+namespace arti::utils {
+
+    thread_pool::thread_pool(uint32_t nThreads)
+      : m_job(nullptr),
+        m_generation(0),
+        m_pending(0),
+        m_stop(false) {
+        resize(nThreads);
+    }
+
+    thread_pool::~thread_pool() {
+        stop();
+    }
+
+    void thread_pool::resize(uint32_t nThreads) {
+        if (nThreads == 0) {
+            nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        if (nThreads == size())
+            return;
+
+        stop();
+
+        m_stop = false;
+        m_generation = 0;
+        for (uint32_t worker = 1; worker < nThreads; ++worker) {
+            m_threads.emplace_back(&thread_pool::workerLoop, this, worker);
+        }
+    }
+
+    uint32_t thread_pool::size() const {
+        return static_cast<uint32_t>(m_threads.size()) + 1;
+    }
+
+    void thread_pool::run(const std::function<void(uint32_t)> &job) {
+        {
+            std::lock_guard lock(m_mutex);
+            m_job = &job;
+            m_exception = nullptr;
+            m_pending = static_cast<uint32_t>(m_threads.size());
+            ++m_generation;
+        }
+        m_wakeUp.notify_all();
+
+        execute(0);
+
+        std::unique_lock lock(m_mutex);
+        m_finished.wait(lock, [this] { return m_pending == 0; });
+        m_job = nullptr;
+
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+    void thread_pool::workerLoop(uint32_t worker) {
+        uint64_t lastGeneration = 0;
+
+        while (true) {
+            {
+                std::unique_lock lock(m_mutex);
+                m_wakeUp.wait(lock, [&] { return m_stop || m_generation != lastGeneration; });
+                if (m_stop)
+                    return;
+                lastGeneration = m_generation;
+            }
+
+            execute(worker);
+
+            {
+                std::lock_guard lock(m_mutex);
+                --m_pending;
+            }
+            m_finished.notify_one();
+        }
+    }
+
+    void thread_pool::execute(uint32_t worker) {
+        try {
+            (*m_job)(worker);
+        }
+        catch (...) {
+            std::lock_guard lock(m_mutex);
+            if (! m_exception)
+                m_exception = std::current_exception();
+        }
+    }
+
+    void thread_pool::stop() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeUp.notify_all();
+
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+        m_threads.clear();
+    }
+
+}